@@ -0,0 +1,363 @@
+#ifndef CPPPRJ_ARENA_H
+#define CPPPRJ_ARENA_H
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "Snake.h"
+
+///step() of Arena moved the snake into a part of another snake
+constexpr int Collision_event = 5;
+///step() of Arena moved the snake into a cell where a longer or equal head arrived
+constexpr int Head_event = 6;
+///step() of Arena didn't move the snake, it was out before the step
+constexpr int Out_event = 7;
+
+/** \brief one snake of Arena
+ *
+ * Parts between the tail and the head are found by the links of the arena.
+ */
+struct Arena_snake {
+    ///Vector object that show snake head displacement after one move.
+    Vector delta = Vector(0, -1);
+    ///Vector object that saves delta after move.
+    Vector last_delta = Vector(0, -1);
+    ///cell of the head
+    Vector head;
+    ///cell of the tail
+    Vector tail;
+    ///number of parts, kept after the snake is out
+    int length = 0;
+    ///false after the snake lost
+    bool alive = false;
+    ///the snake takes the apple in front of its head in the current step
+    bool eats = false;
+
+    /** \brief change direction to up if it wasn't down
+     */
+    void up() {
+        if (last_delta + Vector(0, -1) != Vector(0, 0))
+            delta = Vector(0, -1);
+    }
+
+    /** \brief change direction to right if it wasn't left
+     */
+    void right() {
+        if (last_delta + Vector(1, 0) != Vector(0, 0))
+            delta = Vector(1, 0);
+    }
+
+    /** \brief change direction to left if it wasn't right
+     */
+    void left() {
+        if (last_delta + Vector(-1, 0) != Vector(0, 0))
+            delta = Vector(-1, 0);
+    }
+
+    /** \brief change direction to down if it wasn't up
+     */
+    void down() {
+        if (last_delta + Vector(0, 1) != Vector(0, 0))
+            delta = Vector(0, 1);
+    }
+};
+
+/** \brief game of many snakes on one Field with simultaneous moves.
+ *
+ * All snakes are Snake_id cells of the shared field, so renderers of Field draw the arena;
+ * owner() tells which snake a part belongs to. Every snake cell keeps the direction code
+ * to the next part towards the head, so a move touches the head and the tail only.
+ * A step is resolved from the state before it, in passes over the snakes:
+ * 1. Every live snake claims the cell in front of its head, a claim keeps the longest
+ *    length and how many heads have it.
+ * 2. A snake eats if that cell is an apple and it is the only longest head there,
+ *    otherwise its tail leaves.
+ * 3. A snake is out if it moves into a wall (Wall_event), a part that doesn't leave
+ *    (Self_event or Collision_event), or a cell claimed by a longer or equally long
+ *    head (Head_event). So two heads swapping cells both hit a part, a contested apple
+ *    goes to the longest head and stays if the longest heads tie, and a tail may be
+ *    followed unless its snake eats.
+ * 4. Parts of snakes that are out are emptied and tails of the others leave.
+ * 5. Heads move and a new apple is placed for every eaten one, in the order of snakes.
+ * Claims are stamped with the step number, so nothing is cleared or allocated per step
+ * and the cost is proportional to the number of snakes, plus the parts of snakes that
+ * went out. Same seed and same turns give the same game.
+ */
+class Arena {
+public:
+    ///shared field, snake parts are Snake_id cells
+    Field field;
+    ///snakes in the order of resolution
+    std::vector<Arena_snake> snakes;
+
+    /** \brief create field and snakes
+     *
+     * Snakes of length 2 face up, spread over a grid of ceil(sqrt(count)) columns.
+     * Size must be at least 3 * (columns + 1).
+     *
+     * @param size - size of the field
+     * @param count - number of snakes, 1-255
+     * @param seed - seed of field's random engine
+     * @param apples - number of apples on the field
+     * @throws std::invalid_argument if count is out of range or the field is too small
+     */
+    Arena(int size, int count, unsigned seed, int apples = 1)
+            : field(size, seed), snakes(std::size_t(checked_count(size, count))),
+              links(std::size_t(size) * size, 0), owners(std::size_t(size) * size, 0),
+              claims(std::size_t(size) * size), results(std::size_t(count)) {
+        this->apples = apples;
+        start();
+    }
+
+    /** \brief restart game, the random engine goes on
+     *
+     * @return true if game is restarted successfully
+     */
+    bool new_game() {
+        field.clear();
+        start();
+        return true;
+    }
+
+    /** \brief move every live snake at once
+     *
+     * @return results of snakes by index, snakes that were out get Out_event
+     */
+    const Step_result *step() {
+        next_tick();
+        for (Arena_snake &snake : snakes) {
+            if (not snake.alive)
+                continue;
+            Claim &claim = claims[index(snake.head + snake.delta)];
+            if (claim.claimed != tick) {
+                claim.claimed = tick;
+                claim.length = snake.length;
+                claim.count = 1;
+            } else if (snake.length > claim.length) {
+                claim.length = snake.length;
+                claim.count = 1;
+            } else if (snake.length == claim.length)
+                claim.count++;
+        }
+        for (Arena_snake &snake : snakes) {
+            if (not snake.alive)
+                continue;
+            Vector next = snake.head + snake.delta;
+            const Claim &claim = claims[index(next)];
+            snake.eats = field.body[next.x][next.y] == Apple_id and claim.length == snake.length and claim.count == 1;
+            if (not snake.eats)
+                claims[index(snake.tail)].vacated = tick;
+        }
+        for (std::size_t k = 0; k < snakes.size(); k++) {
+            const Arena_snake &snake = snakes[k];
+            if (not snake.alive) {
+                results[k].event = Out_event;
+                continue;
+            }
+            Vector next = snake.head + snake.delta;
+            const Claim &claim = claims[index(next)];
+            int id = field.body[next.x][next.y];
+            if (id == Wall_id)
+                results[k].event = Wall_event;
+            else if (id == Snake_id and claim.vacated != tick)
+                results[k].event = owners[index(next)] == k ? Self_event : Collision_event;
+            else if (claim.length != snake.length or claim.count > 1)
+                results[k].event = Head_event;
+            else
+                results[k].event = snake.eats ? Ate_event : Moved_event;
+        }
+        for (std::size_t k = 0; k < snakes.size(); k++) {
+            Arena_snake &snake = snakes[k];
+            if (not snake.alive)
+                continue;
+            if (not results[k].working())
+                remove(snake);
+            else if (not snake.eats) {
+                int tail = index(snake.tail);
+                field.body[snake.tail.x][snake.tail.y] = Empty_id;
+                snake.tail = snake.tail + direction_vector(links[tail]);
+            }
+        }
+        int eaten = 0;
+        for (std::size_t k = 0; k < snakes.size(); k++) {
+            Arena_snake &snake = snakes[k];
+            if (not snake.alive)
+                continue;
+            links[index(snake.head)] = (unsigned char) direction_code(snake.delta);
+            snake.last_delta = snake.delta;
+            snake.head = snake.head + snake.delta;
+            field.body[snake.head.x][snake.head.y] = Snake_id;
+            owners[index(snake.head)] = (unsigned char) k;
+            if (snake.eats) {
+                snake.length++;
+                eaten++;
+            }
+        }
+        for (; eaten > 0; eaten--)
+            if (free_cells > 0) {
+                field.create_apple();
+                free_cells--;
+            }
+        for (std::size_t k = 0; k < snakes.size(); k++) {
+            results[k].ate = results[k].event == Ate_event;
+            results[k].length = snakes[k].length;
+            results[k].apple = field.apple;
+        }
+        return results.data();
+    }
+
+    /** \brief number of snakes that aren't out
+     *
+     * @return number of live snakes
+     */
+    int alive() const {
+        return alive_count;
+    }
+
+    /** \brief snake a part belongs to
+     *
+     * @param cell - Snake_id cell of the field
+     * @return index of the snake
+     */
+    int owner(const Vector &cell) const {
+        return owners[index(cell)];
+    }
+
+    /** \brief put an apple on an empty cell, for scripted positions
+     *
+     * @param cell - cell inside the walls
+     * @return true if the cell was empty
+     */
+    bool place_apple(const Vector &cell) {
+        if (field.body[cell.x][cell.y] != Empty_id)
+            return false;
+        field.body[cell.x][cell.y] = Apple_id;
+        field.apple = cell;
+        free_cells--;
+        return true;
+    }
+
+private:
+    /** \brief heads that want a cell in the current step
+     */
+    struct Claim {
+        ///step in which a head claimed the cell
+        unsigned claimed = 0;
+        ///step in which the tail in the cell leaves
+        unsigned vacated = 0;
+        ///length of the longest claiming snake
+        int length = 0;
+        ///number of claiming snakes with that length
+        int count = 0;
+    };
+
+    ///direction code to the next part towards the head, by cell index
+    std::vector<unsigned char> links;
+    ///index of the snake of a part, by cell index
+    std::vector<unsigned char> owners;
+    ///claims by cell index
+    std::vector<Claim> claims;
+    ///results of the last step
+    std::vector<Step_result> results;
+    ///number of steps, stamp of the claims
+    unsigned tick = 0;
+    ///number of apples placed at the start
+    int apples = 1;
+    ///number of empty cells inside the walls
+    int free_cells = 0;
+    ///number of live snakes
+    int alive_count = 0;
+
+    /** \brief index of a cell in links, owners and claims
+     *
+     * @param cell - cell of the field
+     * @return index
+     */
+    int index(const Vector &cell) const {
+        return cell.x * field.size + cell.y;
+    }
+
+    /** \brief columns of the start grid
+     *
+     * @param count - number of snakes
+     * @return ceil(sqrt(count))
+     */
+    static int start_columns(int count) {
+        return int(std::ceil(std::sqrt(double(count))));
+    }
+
+    /** \brief check the number of snakes and the size of the field
+     *
+     * @param size - size of the field
+     * @param count - number of snakes
+     * @return count
+     * @throws std::invalid_argument if owners can't hold count or snakes don't fit the start grid
+     */
+    static int checked_count(int size, int count) {
+        if (count < 1 or count > 255)
+            throw std::invalid_argument("Arena needs 1 to 255 snakes");
+        if (size < 3 * (start_columns(count) + 1))
+            throw std::invalid_argument("Arena field is too small for the snakes");
+        return count;
+    }
+
+    /** \brief advance the stamp, clear the claims when it wraps around
+     */
+    void next_tick() {
+        if (++tick == 0) {
+            std::fill(claims.begin(), claims.end(), Claim());
+            tick = 1;
+        }
+    }
+
+    /** \brief place snakes and apples on the empty field
+     */
+    void start() {
+        int count = int(snakes.size());
+        int columns = start_columns(count);
+        int rows = (count + columns - 1) / columns;
+        free_cells = (field.size - 2) * (field.size - 2);
+        for (int k = 0; k < count; k++) {
+            Arena_snake &snake = snakes[k];
+            int x = (k % columns + 1) * field.size / (columns + 1);
+            int y = (k / columns + 1) * field.size / (rows + 1);
+            snake.delta = Vector(0, -1);
+            snake.last_delta = snake.delta;
+            snake.head = Vector(x, y);
+            snake.tail = Vector(x, y + 1);
+            snake.length = 2;
+            snake.alive = true;
+            snake.eats = false;
+            links[index(snake.tail)] = (unsigned char) direction_code(Vector(0, -1));
+            field.body[x][y] = Snake_id;
+            field.body[x][y + 1] = Snake_id;
+            owners[index(snake.head)] = (unsigned char) k;
+            owners[index(snake.tail)] = (unsigned char) k;
+            free_cells -= 2;
+        }
+        alive_count = count;
+        for (int k = 0; k < apples and free_cells > 0; k++) {
+            field.create_apple();
+            free_cells--;
+        }
+    }
+
+    /** \brief empty the parts of a snake and mark it out
+     *
+     * @param snake - live snake
+     */
+    void remove(Arena_snake &snake) {
+        Vector part = snake.tail;
+        for (int k = 1; k < snake.length; k++) {
+            field.body[part.x][part.y] = Empty_id;
+            part = part + direction_vector(links[index(part)]);
+        }
+        field.body[part.x][part.y] = Empty_id;
+        free_cells += snake.length;
+        snake.alive = false;
+        alive_count--;
+    }
+};
+
+#endif //CPPPRJ_ARENA_H
@@ -0,0 +1,18 @@
+#ifndef CPPPRJ_ATLAS_H
+#define CPPPRJ_ATLAS_H
+
+#include "Atlas_data.h"
+
+/** \brief embedded texture atlas.
+ *
+ * Atlas_data.h is generated at build time by pack_assets from the images in source/.
+ * Tiles of the cells are packed in the order of cell ids, so the id of a cell is
+ * the index of its tile in atlas_rects.
+ */
+
+///index of play button image in atlas_rects
+constexpr int Play_button_tile = 4;
+
+static_assert(atlas_count == Play_button_tile + 1, "atlas must contain four cell tiles and play button");
+
+#endif //CPPPRJ_ATLAS_H
@@ -0,0 +1,175 @@
+#ifndef CPPPRJ_BATCH_H
+#define CPPPRJ_BATCH_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "Snake.h"
+#include "Bot.h"
+#include "Workers.h"
+
+/** \brief many independent games of one engine for batched environments.
+ *
+ * Games are kept in one array, game k is seeded with seed + k, so a batch is reproducible.
+ * safe_actions() masks of all games are kept in one byte array. step() computes the mask
+ * of a game right after its move, while the cells around the head are in cache, so reading
+ * masks of the whole batch costs nothing more. After games are changed directly
+ * update_masks() must be called.
+ * With auto reset a game that ended is copied to its terminal slot and restarted in the
+ * same step, so the caller sees the final state in terminal_game() and the mask of the
+ * new game. step_async() runs a step on worker threads, so the caller can compute actions
+ * of another batch meanwhile. Games are split between threads, results don't depend on
+ * the number of threads.
+ *
+ * @tparam Game - Snake or other Basic_snake
+ */
+template<class Game>
+class Batch {
+public:
+    ///games of the batch
+    std::vector<Game> games;
+
+    /** \brief create games
+     *
+     * @param count - number of games
+     * @param size - size of every field
+     * @param seed - seed of the first game
+     * @param auto_reset - restart games that ended inside step(), bodies of games and terminal
+     * slots are reserved for every interior cell, so steps never allocate
+     * @param threads - number of background threads for steps, 0 steps on the calling thread
+     */
+    Batch(int count, int size, unsigned seed, bool auto_reset = false, int threads = 0)
+            : auto_reset(auto_reset), workers(threads) {
+        games.reserve(count);
+        for (int k = 0; k < count; k++)
+            games.emplace_back(size, seed + unsigned(k));
+        if (auto_reset) {
+            terminal = games;
+            for (std::size_t k = 0; k < games.size(); k++) {
+                games[k].reserve_body();
+                terminal[k].reserve_body();
+            }
+        }
+        masks.resize(games.size());
+        actions.resize(games.size());
+        results.resize(games.size());
+        update_masks();
+    }
+
+    /** \brief number of games
+     *
+     * @return number of games
+     */
+    std::size_t size() const {
+        return games.size();
+    }
+
+    /** \brief turn and move every game
+     *
+     * Without auto reset games that ended stay as they are until they are restarted.
+     *
+     * @param actions - size() direction codes, see apply_action()
+     * @param results - size() results of step() are written here
+     */
+    void step(const unsigned char *actions, Step_result *results) {
+        this->step_actions = actions;
+        this->step_results = results;
+        workers.parallel_for(int(games.size()), [this](int begin, int end) {
+            step_range(begin, end);
+        });
+    }
+
+    /** \brief start a step on the worker threads and return
+     *
+     * Actions are copied, so the buffer may be reused at once. Until wait() the games,
+     * masks and results must not be used. Without threads the step is done before return.
+     *
+     * @param actions - size() direction codes, see apply_action()
+     */
+    void step_async(const unsigned char *actions) {
+        std::copy(actions, actions + games.size(), this->actions.begin());
+        this->step_actions = this->actions.data();
+        this->step_results = this->results.data();
+        workers.start(int(games.size()), [this](int begin, int end) {
+            step_range(begin, end);
+        });
+    }
+
+    /** \brief block until the step started by step_async() is finished
+     *
+     * @return size() results of the step
+     */
+    const Step_result *wait() {
+        workers.wait();
+        return results.data();
+    }
+
+    /** \brief safe_actions() of every game after the last step
+     *
+     * @return size() 4-bit masks, mask of game k is at index k
+     */
+    const unsigned char *safe_actions() const {
+        return masks.data();
+    }
+
+    /** \brief final state of a game restarted by auto reset
+     *
+     * Valid after a step whose result for the game isn't working().
+     *
+     * @param k - index of the game
+     * @return game as it ended
+     */
+    const Game &terminal_game(std::size_t k) const {
+        return terminal[k];
+    }
+
+    /** \brief recompute masks of every game
+     *
+     * Needed after games are changed or restarted directly.
+     */
+    void update_masks() {
+        for (std::size_t k = 0; k < games.size(); k++)
+            masks[k] = (unsigned char) ::safe_actions(games[k]);
+    }
+
+private:
+    ///restart games that ended inside step()
+    bool auto_reset;
+    ///final states of games restarted by auto reset, empty without it
+    std::vector<Game> terminal;
+    ///safe_actions() of every game
+    std::vector<unsigned char> masks;
+    ///actions of the step started by step_async()
+    std::vector<unsigned char> actions;
+    ///results of the step started by step_async()
+    std::vector<Step_result> results;
+    ///direction codes of the running step
+    const unsigned char *step_actions = nullptr;
+    ///results of the running step
+    Step_result *step_results = nullptr;
+    ///threads running steps
+    Workers workers;
+
+    /** \brief step games [begin, end) with step_actions into step_results
+     *
+     * Jobs capture only this, so they fit in std::function without allocation. Copy
+     * assignment to a reserved terminal slot reuses its buffers.
+     *
+     * @param begin - first game
+     * @param end - game after the last one
+     */
+    void step_range(int begin, int end) {
+        for (int k = begin; k < end; k++) {
+            Game &game = games[k];
+            apply_action(game, step_actions[k]);
+            Step_result &result = step_results[k] = game.step();
+            if (auto_reset and not result.working()) {
+                terminal[k] = game;
+                game.new_game();
+            }
+            masks[k] = (unsigned char) ::safe_actions(game);
+        }
+    }
+};
+
+#endif //CPPPRJ_BATCH_H
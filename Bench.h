@@ -0,0 +1,242 @@
+#ifndef CPPPRJ_BENCH_H
+#define CPPPRJ_BENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Perf_counters.h"
+
+/** \brief timing of one benchmark
+ */
+struct Bench_result {
+    ///name of the benchmark
+    std::string name;
+    ///number of timed operations in one repetition
+    long long iterations = 0;
+    ///median time of one operation in nanoseconds
+    double ns_per_op = 0;
+    ///items processed by one operation, like cells of a copied field
+    double items_per_op = 1;
+    ///time of one operation in nanoseconds for every repetition
+    std::vector<double> samples;
+    ///hardware events of one operation over all repetitions, negative if not counted
+    Perf_counts counters;
+
+    /** \brief throughput of the median repetition
+     *
+     * @return items per second, 0 if nothing was timed
+     */
+    double items_per_second() const {
+        return ns_per_op > 0 ? items_per_op * 1e9 / ns_per_op : 0.;
+    }
+};
+
+///comma separated parts, only benchmarks with names containing one of them are run, all if it's empty
+inline std::string bench_filter;
+
+///number of timed repetitions of every benchmark
+inline int bench_repetitions = 1;
+
+/** \brief hardware counters of the benchmark thread
+ *
+ * Opened on first use, nothing is counted if perf_event_open is unavailable.
+ *
+ * @return counters
+ */
+inline Perf_counters &bench_counters() {
+    static Perf_counters counters;
+    return counters;
+}
+
+///sink for benchmark results, keeps the compiler from dropping the timed work
+inline volatile long long bench_sink = 0;
+
+/** \brief keep a value and make the compiler assume that memory changed
+ *
+ * Without it pure operations on unchanged data may be hoisted out of the timed loop.
+ *
+ * @param value - result of an operation
+ */
+template<class Value>
+inline void keep(const Value &value) {
+#if defined(__GNUC__) or defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    bench_sink = bench_sink + (long long) value;
+#endif
+}
+
+/** \brief check name against bench_filter
+ *
+ * @param name - name of the benchmark
+ * @return true if the benchmark should run
+ */
+inline bool bench_selected(const std::string &name) {
+    std::size_t begin = 0;
+    while (true) {
+        std::size_t end = std::min(bench_filter.find(',', begin), bench_filter.size());
+        if (name.find(bench_filter.substr(begin, end - begin)) != std::string::npos)
+            return true;
+        if (end == bench_filter.size())
+            return false;
+        begin = end + 1;
+    }
+}
+
+/** \brief time an operation
+ *
+ * Number of iterations is doubled until one run lasts at least min_seconds, then
+ * bench_repetitions runs of that length are timed and the median is kept.
+ * Hardware counters cover the last doubling run and the repetitions, all of the same length.
+ * Benchmarks skipped by bench_filter have no iterations.
+ *
+ * @param name - name of the benchmark
+ * @param operation - callable that does one operation and returns its result
+ * @param min_seconds - shortest timed run
+ * @param items_per_op - items processed by one operation
+ * @return timing of the benchmark
+ */
+template<class Operation>
+Bench_result run_bench(const std::string &name, Operation &&operation, double min_seconds = 0.1,
+                       double items_per_op = 1) {
+    using Clock = std::chrono::steady_clock;
+    Bench_result result;
+    result.name = name;
+    result.items_per_op = items_per_op;
+    if (not bench_selected(name))
+        return result;
+    Perf_counters &counters = bench_counters();
+    auto timed = [&](long long iterations) {
+        counters.start();
+        Clock::time_point start = Clock::now();
+        for (long long k = 0; k < iterations; k++)
+            keep(operation());
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        counters.stop();
+        return seconds;
+    };
+    long long iterations = 1;
+    double seconds = timed(iterations);
+    while (seconds < min_seconds and iterations < (1ll << 40)) {
+        iterations *= 2;
+        seconds = timed(iterations);
+    }
+    result.iterations = iterations;
+    result.samples.push_back(seconds * 1e9 / double(iterations));
+    Perf_counts counts = counters.read();
+    for (int k = 1; k < bench_repetitions; k++) {
+        result.samples.push_back(timed(iterations) * 1e9 / double(iterations));
+        counts.add(counters.read());
+    }
+    result.counters = counts.per(double(iterations) * double(result.samples.size()));
+    std::vector<double> sorted = result.samples;
+    std::sort(sorted.begin(), sorted.end());
+    std::size_t middle = sorted.size() / 2;
+    result.ns_per_op = sorted.size() % 2 == 1 ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) / 2;
+    return result;
+}
+
+/** \brief print counted value, or a dash if it wasn't counted
+ *
+ * @param value - value, negative if not counted
+ * @param unit - unit after the value
+ */
+inline void print_count(double value, const char *unit) {
+    if (value >= 0)
+        std::printf(" %8.3f %s", value, unit);
+    else
+        std::printf(" %8s %s", "-", unit);
+}
+
+/** \brief print one result as a table row, skipped benchmarks aren't printed
+ *
+ * Hardware counters are appended only if something was counted.
+ *
+ * @param result - timing of a benchmark
+ */
+inline void print_result(const Bench_result &result) {
+    if (result.iterations == 0)
+        return;
+    std::printf("%-40s %12.1f ns/op %12.4g items/s %14lld ops", result.name.c_str(), result.ns_per_op,
+                result.items_per_second(), result.iterations);
+    if (result.counters.any()) {
+        print_count(result.counters.ipc(), "IPC");
+        print_count(result.counters.l1_misses, "L1 miss/op");
+        print_count(result.counters.llc_misses, "LLC miss/op");
+        print_count(result.counters.branch_misses, "br miss/op");
+    }
+    std::printf("\n");
+}
+
+/** \brief results of a benchmark run printed as a table and saved as JSON.
+ */
+class Bench_report {
+public:
+    /** \brief print result and keep it for JSON, skipped benchmarks are dropped
+     *
+     * @param result - timing of a benchmark
+     */
+    void add(const Bench_result &result) {
+        if (result.iterations == 0)
+            return;
+        print_result(result);
+        std::fflush(stdout);
+        results.push_back(result);
+    }
+
+    /** \brief write kept results
+     *
+     * Format: {"repetitions", "benchmarks": [{"name", "iterations", "ns_per_op", "items_per_second", "samples",
+     * "counters"}]}. "counters" holds cycles, instructions, l1_misses, llc_misses and branch_misses
+     * of one operation and ipc, only the counted ones; it is left out if nothing was counted.
+     *
+     * @param out - output file
+     * @return true if everything is written
+     */
+    bool write_json(std::FILE *out) const {
+        bool written = std::fprintf(out, "{\n  \"repetitions\": %d,\n  \"benchmarks\": [", bench_repetitions) > 0;
+        for (std::size_t k = 0; k < results.size(); k++) {
+            const Bench_result &result = results[k];
+            std::string name;
+            for (char c : result.name) {
+                if (c == '"' or c == '\\')
+                    name += '\\';
+                name += c;
+            }
+            written = written and std::fprintf(out, "%s\n    {\"name\": \"%s\", \"iterations\": %lld, "
+                                                    "\"ns_per_op\": %.6g, \"items_per_second\": %.6g, \"samples\": [",
+                                               k == 0 ? "" : ",", name.c_str(), result.iterations,
+                                               result.ns_per_op, result.items_per_second()) > 0;
+            for (std::size_t s = 0; s < result.samples.size(); s++)
+                written = written and std::fprintf(out, "%s%.6g", s == 0 ? "" : ", ", result.samples[s]) > 0;
+            written = written and std::fprintf(out, "]") > 0;
+            const Perf_counts &counts = result.counters;
+            if (counts.any()) {
+                const std::pair<const char *, double> values[] = {
+                        {"cycles", counts.cycles}, {"instructions", counts.instructions}, {"ipc", counts.ipc()},
+                        {"l1_misses", counts.l1_misses}, {"llc_misses", counts.llc_misses},
+                        {"branch_misses", counts.branch_misses}};
+                const char *separator = "";
+                written = written and std::fprintf(out, ", \"counters\": {") > 0;
+                for (const auto &value : values)
+                    if (value.second >= 0) {
+                        written = written and std::fprintf(out, "%s\"%s\": %.6g", separator, value.first,
+                                                           value.second) > 0;
+                        separator = ", ";
+                    }
+                written = written and std::fprintf(out, "}") > 0;
+            }
+            written = written and std::fprintf(out, "}") > 0;
+        }
+        return written and std::fprintf(out, "\n  ]\n}\n") > 0;
+    }
+
+private:
+    ///kept results
+    std::vector<Bench_result> results;
+};
+
+#endif //CPPPRJ_BENCH_H
@@ -0,0 +1,357 @@
+#ifndef CPPPRJ_BENCH_COMPARE_H
+#define CPPPRJ_BENCH_COMPARE_H
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+/** \brief timings of one benchmark read from snake_bench JSON
+ */
+struct Bench_samples {
+    ///name of the benchmark
+    std::string name;
+    ///time of one operation in nanoseconds for every repetition
+    std::vector<double> samples;
+};
+
+/** \brief reader of the JSON written by Bench_report.
+ *
+ * Accepts any valid JSON, keeps name and samples of every object in "benchmarks".
+ * Objects without samples use their ns_per_op as the only sample.
+ */
+class Bench_json_reader {
+public:
+    /** \brief bind text
+     *
+     * @param text - JSON text
+     */
+    explicit Bench_json_reader(const std::string &text) : text(text) {}
+
+    /** \brief read benchmarks
+     *
+     * @param benchmarks - read benchmarks are appended here
+     * @return true if the text is valid JSON with a "benchmarks" array
+     */
+    bool read(std::vector<Bench_samples> &benchmarks) {
+        position = 0;
+        bool found = false;
+        if (not expect('{'))
+            return false;
+        if (expect('}'))
+            return at_end() and found;
+        do {
+            std::string key;
+            if (not read_string(key) or not expect(':'))
+                return false;
+            if (key == "benchmarks") {
+                if (not read_benchmarks(benchmarks))
+                    return false;
+                found = true;
+            } else if (not skip_value())
+                return false;
+        } while (expect(','));
+        return expect('}') and at_end() and found;
+    }
+
+private:
+    ///JSON text
+    const std::string &text;
+    ///position of the next character
+    std::size_t position = 0;
+
+    /** \brief skip whitespace
+     */
+    void skip_space() {
+        while (position < text.size() and std::isspace((unsigned char) text[position]))
+            position++;
+    }
+
+    /** \brief consume character if it is next
+     *
+     * @param c - expected character
+     * @return true if it was consumed
+     */
+    bool expect(char c) {
+        skip_space();
+        if (position < text.size() and text[position] == c) {
+            position++;
+            return true;
+        }
+        return false;
+    }
+
+    /** \brief check that only whitespace is left
+     *
+     * @return true at the end of the text
+     */
+    bool at_end() {
+        skip_space();
+        return position == text.size();
+    }
+
+    /** \brief read string with escapes, \\u escapes are kept as they are
+     *
+     * @param value - read string
+     * @return true if a string is read
+     */
+    bool read_string(std::string &value) {
+        if (not expect('"'))
+            return false;
+        value.clear();
+        while (position < text.size() and text[position] != '"') {
+            if (text[position] == '\\' and position + 1 < text.size()) {
+                position++;
+                char c = text[position];
+                value += c == 'n' ? '\n' : c == 't' ? '\t' : c == 'u' ? '\\' : c;
+                if (c == 'u')
+                    value += 'u';
+            } else
+                value += text[position];
+            position++;
+        }
+        if (position == text.size())
+            return false;
+        position++;
+        return true;
+    }
+
+    /** \brief read number
+     *
+     * @param value - read number
+     * @return true if a number is read
+     */
+    bool read_number(double &value) {
+        skip_space();
+        const char *begin = text.c_str() + position;
+        char *end = nullptr;
+        value = std::strtod(begin, &end);
+        if (end == begin)
+            return false;
+        position += std::size_t(end - begin);
+        return true;
+    }
+
+    /** \brief skip any value
+     *
+     * @return true if a valid value is skipped
+     */
+    bool skip_value() {
+        skip_space();
+        if (position == text.size())
+            return false;
+        char c = text[position];
+        std::string word;
+        double number;
+        if (c == '"')
+            return read_string(word);
+        if (c == '{' or c == '[') {
+            char close = c == '{' ? '}' : ']';
+            position++;
+            if (expect(close))
+                return true;
+            do {
+                if (c == '{' and (not read_string(word) or not expect(':')))
+                    return false;
+                if (not skip_value())
+                    return false;
+            } while (expect(','));
+            return expect(close);
+        }
+        for (const char *literal : {"true", "false", "null"})
+            if (text.compare(position, std::string(literal).size(), literal) == 0) {
+                position += std::string(literal).size();
+                return true;
+            }
+        return read_number(number);
+    }
+
+    /** \brief read array of numbers
+     *
+     * @param values - read numbers are appended here
+     * @return true if the array is valid
+     */
+    bool read_numbers(std::vector<double> &values) {
+        if (not expect('['))
+            return false;
+        if (expect(']'))
+            return true;
+        do {
+            double value;
+            if (not read_number(value))
+                return false;
+            values.push_back(value);
+        } while (expect(','));
+        return expect(']');
+    }
+
+    /** \brief read array of benchmark objects
+     *
+     * @param benchmarks - read benchmarks are appended here
+     * @return true if the array is valid
+     */
+    bool read_benchmarks(std::vector<Bench_samples> &benchmarks) {
+        if (not expect('['))
+            return false;
+        if (expect(']'))
+            return true;
+        do {
+            Bench_samples benchmark;
+            double ns_per_op = -1;
+            if (not expect('{'))
+                return false;
+            if (not expect('}')) {
+                do {
+                    std::string key;
+                    if (not read_string(key) or not expect(':'))
+                        return false;
+                    bool valid = key == "name" ? read_string(benchmark.name)
+                                               : key == "samples" ? read_numbers(benchmark.samples)
+                                                                  : key == "ns_per_op" ? read_number(ns_per_op)
+                                                                                       : skip_value();
+                    if (not valid)
+                        return false;
+                } while (expect(','));
+                if (not expect('}'))
+                    return false;
+            }
+            if (benchmark.samples.empty() and ns_per_op >= 0)
+                benchmark.samples.push_back(ns_per_op);
+            if (not benchmark.name.empty() and not benchmark.samples.empty())
+                benchmarks.push_back(benchmark);
+        } while (expect(','));
+        return expect(']');
+    }
+};
+
+/** \brief median of values
+ *
+ * @param values - values, not empty
+ * @return median
+ */
+inline double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    std::size_t middle = values.size() / 2;
+    return values.size() % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+/** \brief comparison of one benchmark
+ */
+struct Bench_change {
+    ///name of the benchmark
+    std::string name;
+    ///median of the baseline in nanoseconds
+    double baseline = 0;
+    ///median of the current run in nanoseconds, 0 if it is missing
+    double current = 0;
+    ///current median divided by baseline median
+    double ratio = 0;
+    ///lower bound of the 95% confidence interval of the ratio
+    double low = 0;
+    ///upper bound of the 95% confidence interval of the ratio
+    double high = 0;
+    ///benchmark isn't in the current run
+    bool missing = false;
+    ///slower by more than the threshold with 95% confidence
+    bool regressed = false;
+    ///faster by more than the threshold with 95% confidence
+    bool improved = false;
+};
+
+/** \brief compare samples of one benchmark
+ *
+ * Confidence interval of the median ratio is a percentile bootstrap with fixed seed,
+ * so the same files give the same verdict. With one sample on both sides it is the ratio itself.
+ *
+ * @param name - name of the benchmark
+ * @param baseline - baseline samples, not empty
+ * @param current - current samples, not empty
+ * @param threshold - allowed relative slowdown, 0.1 is 10%
+ * @param resamples - number of bootstrap resamples
+ * @return comparison
+ */
+inline Bench_change compare_samples(const std::string &name, const std::vector<double> &baseline,
+                                    const std::vector<double> &current, double threshold, int resamples = 2000) {
+    Bench_change change;
+    change.name = name;
+    change.baseline = median(baseline);
+    change.current = median(current);
+    change.ratio = change.current / change.baseline;
+    std::vector<double> ratios;
+    std::default_random_engine engine(12345);
+    std::vector<double> base_draw(baseline.size()), current_draw(current.size());
+    for (int k = 0; k < resamples and (baseline.size() > 1 or current.size() > 1); k++) {
+        std::uniform_int_distribution<std::size_t> base_pick(0, baseline.size() - 1);
+        std::uniform_int_distribution<std::size_t> current_pick(0, current.size() - 1);
+        for (double &value : base_draw)
+            value = baseline[base_pick(engine)];
+        for (double &value : current_draw)
+            value = current[current_pick(engine)];
+        ratios.push_back(median(current_draw) / median(base_draw));
+    }
+    if (ratios.empty()) {
+        change.low = change.ratio;
+        change.high = change.ratio;
+    } else {
+        std::sort(ratios.begin(), ratios.end());
+        change.low = ratios[std::size_t(0.025 * double(ratios.size() - 1))];
+        change.high = ratios[std::size_t(0.975 * double(ratios.size() - 1))];
+    }
+    change.regressed = change.low > 1 + threshold;
+    change.improved = change.high < 1 - threshold;
+    return change;
+}
+
+/** \brief compare every baseline benchmark with the current run
+ *
+ * Benchmarks only in the current run aren't tracked and are ignored.
+ *
+ * @param baseline - baseline benchmarks
+ * @param current - current benchmarks
+ * @param threshold - allowed relative slowdown
+ * @return comparisons in baseline order
+ */
+inline std::vector<Bench_change> compare_runs(const std::vector<Bench_samples> &baseline,
+                                              const std::vector<Bench_samples> &current, double threshold) {
+    std::vector<Bench_change> changes;
+    for (const Bench_samples &base : baseline) {
+        auto found = std::find_if(current.begin(), current.end(), [&](const Bench_samples &run) {
+            return run.name == base.name;
+        });
+        if (found == current.end()) {
+            Bench_change change;
+            change.name = base.name;
+            change.baseline = median(base.samples);
+            change.missing = true;
+            changes.push_back(change);
+        } else
+            changes.push_back(compare_samples(base.name, base.samples, found->samples, threshold));
+    }
+    return changes;
+}
+
+/** \brief print comparisons as a table
+ *
+ * @param out - output file
+ * @param changes - comparisons
+ */
+inline void print_changes(std::FILE *out, const std::vector<Bench_change> &changes) {
+    std::fprintf(out, "%-36s %12s %12s %8s %19s  %s\n", "benchmark", "base ns", "new ns", "change", "95% interval",
+                 "verdict");
+    for (const Bench_change &change : changes) {
+        if (change.missing) {
+            std::fprintf(out, "%-36s %12.1f %12s %8s %19s  %s\n", change.name.c_str(), change.baseline, "-", "-", "-",
+                         "MISSING");
+            continue;
+        }
+        const char *verdict = change.regressed ? "REGRESSED" : change.improved ? "improved" : "same";
+        std::fprintf(out, "%-36s %12.1f %12.1f %+7.1f%% [%+7.1f%%, %+7.1f%%]  %s\n", change.name.c_str(),
+                     change.baseline, change.current, (change.ratio - 1) * 100, (change.low - 1) * 100,
+                     (change.high - 1) * 100, verdict);
+    }
+}
+
+#endif //CPPPRJ_BENCH_COMPARE_H
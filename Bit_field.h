@@ -0,0 +1,417 @@
+#ifndef CPPPRJ_BIT_FIELD_H
+#define CPPPRJ_BIT_FIELD_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "Snake.h"
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+/** \brief number of set bits
+ *
+ * @param word - word
+ * @return number of set bits
+ */
+inline int bit_count(std::uint64_t word) {
+#if defined(__GNUC__) or defined(__clang__)
+    return __builtin_popcountll(word);
+#else
+    int total = 0;
+    for (; word != 0; word &= word - 1)
+        total++;
+    return total;
+#endif
+}
+
+/** \brief position of the n-th set bit
+ *
+ * @param word - word with more than n set bits
+ * @param n - number of the set bit, from 0
+ * @return index of the bit
+ */
+inline int select_bit(std::uint64_t word, int n) {
+#if defined(__BMI2__)
+    return int(_tzcnt_u64(_pdep_u64(std::uint64_t(1) << n, word)));
+#else
+    for (; n > 0; n--)
+        word &= word - 1;
+    int index = 0;
+    for (; (word & 1) == 0; word >>= 1)
+        index++;
+    return index;
+#endif
+}
+
+/** \brief cells of a board up to 64x64 kept as bit planes.
+ *
+ * Every plane has one 64-bit word per column x, bit y of the word is cell (x, y).
+ * A cell is a wall, a snake part or an apple if its bit is set in the plane, empty otherwise.
+ */
+class Bit_grid {
+public:
+    ///largest supported size
+    static constexpr int max_size = 64;
+    ///walls plane
+    std::array<std::uint64_t, max_size> walls{};
+    ///snake parts plane
+    std::array<std::uint64_t, max_size> snake{};
+    ///apples plane
+    std::array<std::uint64_t, max_size> apples{};
+
+    /** \brief reference to one cell, converts to id and assigns id
+     */
+    class Cell {
+    public:
+        /** \brief bind cell
+         *
+         * @param grid - grid of the cell
+         * @param x - column
+         * @param y - row
+         */
+        Cell(Bit_grid &grid, int x, int y) : grid(grid), x(x), y(y) {}
+
+        Cell(const Cell &) = default;
+
+        /** \brief id of the cell
+         *
+         * @return cell id
+         */
+        operator int() const {
+            return grid.get(x, y);
+        }
+
+        /** \brief set id of the cell
+         *
+         * @param id - cell id
+         * @return this cell
+         */
+        Cell &operator=(int id) {
+            grid.set(x, y, id);
+            return *this;
+        }
+
+        /** \brief copy id of other cell
+         *
+         * @param other - cell to copy
+         * @return this cell
+         */
+        Cell &operator=(const Cell &other) {
+            grid.set(x, y, int(other));
+            return *this;
+        }
+
+    private:
+        ///grid of the cell
+        Bit_grid &grid;
+        ///column
+        int x;
+        ///row
+        int y;
+    };
+
+    /** \brief one column x of the grid, indexed by y
+     */
+    class Column {
+    public:
+        /** \brief bind column
+         *
+         * @param grid - grid of the column
+         * @param x - column
+         */
+        Column(Bit_grid &grid, int x) : grid(grid), x(x) {}
+
+        /** \brief cell of the column
+         *
+         * @param y - row
+         * @return cell reference
+         */
+        Cell operator[](int y) const {
+            return Cell(grid, x, y);
+        }
+
+        /** \brief length of the column
+         *
+         * @return size of the grid
+         */
+        std::size_t size() const {
+            return grid.size();
+        }
+
+    private:
+        ///grid of the column
+        Bit_grid &grid;
+        ///column
+        int x;
+    };
+
+    /** \brief read-only column x of the grid, indexed by y
+     */
+    class Const_column {
+    public:
+        /** \brief bind column
+         *
+         * @param grid - grid of the column
+         * @param x - column
+         */
+        Const_column(const Bit_grid &grid, int x) : grid(grid), x(x) {}
+
+        /** \brief cell of the column
+         *
+         * @param y - row
+         * @return cell id
+         */
+        int operator[](int y) const {
+            return grid.get(x, y);
+        }
+
+        /** \brief length of the column
+         *
+         * @return size of the grid
+         */
+        std::size_t size() const {
+            return grid.size();
+        }
+
+    private:
+        ///grid of the column
+        const Bit_grid &grid;
+        ///column
+        int x;
+    };
+
+    /** \brief grid with walls on the border
+     *
+     * @param size - size of the grid, 1 to max_size
+     * @throws std::invalid_argument if the size doesn't fit the columns
+     */
+    explicit Bit_grid(int size) {
+        if (size < 1 or size > max_size)
+            throw std::invalid_argument("Bit_grid size must be 1 to 64");
+        this->side = size;
+        std::uint64_t column = size == max_size ? ~std::uint64_t(0) : (std::uint64_t(1) << size) - 1;
+        std::uint64_t border = std::uint64_t(1) | std::uint64_t(1) << (size - 1);
+        walls[0] = column;
+        walls[size - 1] = column;
+        for (int x = 1; x < size - 1; x++)
+            walls[x] = border;
+    }
+
+    /** \brief column of the grid
+     *
+     * @param x - column
+     * @return column proxy indexed by row
+     */
+    Column operator[](int x) {
+        return Column(*this, x);
+    }
+
+    /** \brief column of the grid
+     *
+     * @param x - column
+     * @return column proxy indexed by row
+     */
+    Const_column operator[](int x) const {
+        return Const_column(*this, x);
+    }
+
+    /** \brief number of columns
+     *
+     * @return size of the grid
+     */
+    std::size_t size() const {
+        return std::size_t(side);
+    }
+
+    /** \brief id of cell
+     *
+     * @param x - column
+     * @param y - row
+     * @return cell id
+     */
+    int get(int x, int y) const {
+        std::uint64_t bit = std::uint64_t(1) << y;
+        if (snake[x] & bit)
+            return Snake_id;
+        if (apples[x] & bit)
+            return Apple_id;
+        return walls[x] & bit ? Wall_id : Empty_id;
+    }
+
+    /** \brief set id of cell
+     *
+     * @param x - column
+     * @param y - row
+     * @param id - cell id
+     */
+    void set(int x, int y, int id) {
+        std::uint64_t bit = std::uint64_t(1) << y;
+        walls[x] = (walls[x] & ~bit) | (id == Wall_id ? bit : 0);
+        snake[x] = (snake[x] & ~bit) | (id == Snake_id ? bit : 0);
+        apples[x] = (apples[x] & ~bit) | (id == Apple_id ? bit : 0);
+    }
+
+    /** \brief empty cells of column
+     *
+     * @param x - column
+     * @return bits of empty cells
+     */
+    std::uint64_t empty(int x) const {
+        std::uint64_t column = side == max_size ? ~std::uint64_t(0) : (std::uint64_t(1) << side) - 1;
+        return ~(walls[x] | snake[x] | apples[x]) & column;
+    }
+
+private:
+    ///size of the grid
+    int side;
+};
+
+/** \brief field object for boards up to 64x64 kept as bit planes.
+ *
+ * Drop-in replacement of Field for Basic_snake: same walls and same apple draws for
+ * the same seed. Also has word-parallel queries: select of a random empty cell and
+ * reachable area flood fill.
+ */
+struct Bit_field {
+public:
+    ///Size of the field.
+    int size;
+    ///bit planes of [size * size] cell states
+    Bit_grid body;
+    ///random engine for generating apples
+    std::default_random_engine engine;
+    ///cell of the last created apple
+    Vector apple;
+
+    /**\brief generates field size*size with fixed random seed.
+     *
+     * @param size - size of the field, at most Bit_grid::max_size.
+     * @param seed - seed of random engine.
+     */
+    Bit_field(int size, unsigned seed) : body(size), engine(seed) {
+        this->size = size;
+    }
+
+    /** \brief creates apple at field
+     *
+     * Same draws as Field::create_apple(), cells are tested with one bit test.
+     */
+    void create_apple() {
+        std::uniform_int_distribution<int> x_distribution(1, size - 2);
+        std::uniform_int_distribution<int> y_distribution(1, size - 2);
+        int x = x_distribution(engine);
+        int y = y_distribution(engine);
+        while (not(body.empty(x) >> y & 1)) {
+            x = x_distribution(engine);
+            y = y_distribution(engine);
+        }
+        body.apples[x] |= std::uint64_t(1) << y;
+        apple = Vector(x, y);
+    }
+
+    /** \brief uniformly random empty cell with one random draw
+     *
+     * Counts empty cells per column with popcount and selects the n-th set bit,
+     * so the cost doesn't grow when the board fills up.
+     *
+     * @return empty cell, or Vector(0, 0) if there is none
+     */
+    Vector random_empty_cell() {
+        int total = 0;
+        for (int x = 1; x < size - 1; x++)
+            total += bit_count(body.empty(x));
+        if (total == 0)
+            return Vector(0, 0);
+        int n = std::uniform_int_distribution<int>(0, total - 1)(engine);
+        for (int x = 1;; x++) {
+            int count = bit_count(body.empty(x));
+            if (n < count)
+                return Vector(x, select_bit(body.empty(x), n));
+            n -= count;
+        }
+    }
+
+    /** \brief creates apple at a random empty cell chosen by random_empty_cell()
+     *
+     * Faster than create_apple() on full boards, but draws differ from Field.
+     */
+    void create_apple_select() {
+        Vector cell = random_empty_cell();
+        if (cell != Vector(0, 0)) {
+            body.apples[cell.x] |= std::uint64_t(1) << cell.y;
+            apple = cell;
+        }
+    }
+
+    /** \brief number of free cells connected to a cell
+     *
+     * Free cells are empty cells and apples. Whole columns grow at once with shifts
+     * and masks until nothing changes.
+     *
+     * @param start - first cell
+     * @return number of connected free cells, 0 if start isn't free
+     */
+    int reachable_area(const Vector &start) const {
+        std::array<std::uint64_t, Bit_grid::max_size> free{}, reach{};
+        for (int x = 0; x < size; x++)
+            free[x] = body.empty(x) | body.apples[x];
+        reach[start.x] = free[start.x] & std::uint64_t(1) << start.y;
+        bool changed = reach[start.x] != 0;
+        //only columns next to the reached ones can grow
+        int first = start.x, last = start.x;
+        while (changed) {
+            changed = false;
+            int from = std::max(1, first - 1), to = std::min(size - 2, last + 1);
+            for (int pass = 0; pass < 2; pass++) {
+                for (int k = from; k <= to; k++) {
+                    int x = pass == 0 ? k : from + to - k;
+                    std::uint64_t grown = (reach[x] | reach[x - 1] | reach[x + 1]) & free[x];
+                    while (true) {
+                        std::uint64_t wider = (grown | grown << 1 | grown >> 1) & free[x];
+                        if (wider == grown)
+                            break;
+                        grown = wider;
+                    }
+                    if (grown != reach[x]) {
+                        reach[x] = grown;
+                        first = std::min(first, x);
+                        last = std::max(last, x);
+                        changed = true;
+                    }
+                }
+            }
+        }
+        int total = 0;
+        for (int x = 0; x < size; x++)
+            total += bit_count(reach[x]);
+        return total;
+    }
+
+    /** \brief makes every cell inside the walls empty
+     */
+    void clear() {
+        body.snake.fill(0);
+        body.apples.fill(0);
+    }
+
+    /** \brief makes every cell inside the walls empty
+     *
+     * Clearing two planes is cheaper than clearing parts one by one at every size.
+     *
+     * @param parts - cells of the snake, not used
+     */
+    void clear(const std::vector<Vector> &parts) {
+        (void) parts;
+        clear();
+    }
+};
+
+///snake game on the bit plane field
+using Bit_snake = Basic_snake<Bit_field>;
+
+#endif //CPPPRJ_BIT_FIELD_H
@@ -0,0 +1,95 @@
+#ifndef CPPPRJ_BOT_H
+#define CPPPRJ_BOT_H
+
+#include <random>
+#include "Snake.h"
+
+/** \brief check if the snake survives next move in direction
+ *
+ * Same rules as Snake::move(): empty cell, apple or cell of the tail are safe.
+ *
+ * @param snake - Snake object or other Basic_snake
+ * @param direction - head displacement
+ * @return true if the move doesn't crash
+ */
+template<class Game>
+bool is_safe(const Game &snake, const Vector &direction) {
+    Vector next = snake.body[0] + direction;
+    switch (snake.field.body[next.x][next.y]) {
+        case Empty_id:
+        case Apple_id:
+            return true;
+        case Snake_id:
+            return next == snake.body[snake.body.size() - 1];
+        default:
+            return false;
+    }
+}
+
+/** \brief turn the game like the arrow keys do
+ *
+ * @param snake - Snake object or other engine with up(), right(), down() and left()
+ * @param code - direction code: 0 up, 1 right, 2 down, 3 left, anything else keeps the direction
+ */
+template<class Game>
+void apply_action(Game &snake, int code) {
+    switch (code) {
+        case 0: snake.up(); break;
+        case 1: snake.right(); break;
+        case 2: snake.down(); break;
+        case 3: snake.left(); break;
+        default: break;
+    }
+}
+
+/** \brief directions the snake may turn to and survive the next move
+ *
+ * Bit k is set for direction code k if it isn't the reverse of the last move, which
+ * up(), right(), down() and left() ignore, and is_safe() holds for it, so the tail rule
+ * of move() is included. Eating the last apple is safe.
+ *
+ * @param snake - Snake object or other Basic_snake
+ * @return 4-bit mask of direction codes
+ */
+template<class Game>
+unsigned safe_actions(const Game &snake) {
+    const int dx[4] = {0, 1, 0, -1}, dy[4] = {-1, 0, 1, 0};
+    Vector head = snake.body[0];
+    Vector tail = snake.body[snake.body.size() - 1];
+    unsigned mask = 0;
+    for (int code = 0; code < 4; code++) {
+        int x = head.x + dx[code], y = head.y + dy[code];
+        unsigned id = unsigned(snake.field.body[x][y]);
+        //bits 0 and 3 of 0x9 are Empty_id and Apple_id, so there are no branches on the cell id
+        unsigned free = (0x9u >> id) & 1u;
+        free |= unsigned(id == Snake_id) & unsigned(x == tail.x) & unsigned(y == tail.y);
+        unsigned turn = unsigned(snake.last_delta.x + dx[code] != 0) | unsigned(snake.last_delta.y + dy[code] != 0);
+        mask |= (free & turn) << code;
+    }
+    return mask;
+}
+
+/** \brief simple random bot for watching games
+ *
+ * Keeps direction while it is safe, sometimes turns, avoids crashes when it can.
+ *
+ * @param snake - Snake object or other Basic_snake, its delta is changed
+ * @param engine - random engine of the bot
+ */
+template<class Game>
+void bot_turn(Game &snake, std::default_random_engine &engine) {
+    static const Vector directions[4] = {Vector(0, -1), Vector(1, 0), Vector(0, 1), Vector(-1, 0)};
+    std::uniform_int_distribution<int> turn_distribution(0, 7);
+    if (is_safe(snake, snake.delta) and turn_distribution(engine) != 0)
+        return;
+    int first = turn_distribution(engine) % 4;
+    for (int i = 0; i < 4; i++) {
+        const Vector &direction = directions[(first + i) % 4];
+        if (snake.last_delta + direction != Vector(0, 0) and is_safe(snake, direction)) {
+            snake.delta = direction;
+            return;
+        }
+    }
+}
+
+#endif //CPPPRJ_BOT_H
@@ -0,0 +1,132 @@
+#ifndef CPPPRJ_CAMERA_H
+#define CPPPRJ_CAMERA_H
+
+#include <algorithm>
+#include <cmath>
+#include "Snake.h"
+
+/** \brief range of cells [first_x, last_x) x [first_y, last_y) seen by the camera.
+ */
+struct Cell_range {
+    ///first visible column
+    int first_x;
+    ///column after the last visible one
+    int last_x;
+    ///first visible row
+    int first_y;
+    ///row after the last visible one
+    int last_y;
+
+    /** \brief number of cells in range
+     *
+     * @return number of cells
+     */
+    long long count() const {
+        return (long long) (last_x - first_x) * (last_y - first_y);
+    }
+};
+
+/** \brief camera over the board that follows the snake head.
+ *
+ * All positions are in cell units, cell size is the zoom in pixels per cell.
+ * Small boards fit the viewport like before, large ones are shown around the head.
+ */
+struct Camera {
+    ///smallest cell size in pixels
+    static constexpr float min_cell = 4.f;
+    ///largest cell size in pixels
+    static constexpr float max_cell = 128.f;
+    ///size of the board in cells
+    int board;
+    ///viewport width in pixels
+    float width;
+    ///viewport height in pixels
+    float height;
+    ///cell size in pixels
+    float cell;
+    ///x coordinate of the view center in cells
+    float center_x;
+    ///y coordinate of the view center in cells
+    float center_y;
+
+    /** \brief create camera that shows the whole board if it fits
+     *
+     * @param board - size of the board in cells
+     * @param width - viewport width in pixels
+     * @param height - viewport height in pixels
+     */
+    Camera(int board, float width, float height) {
+        this->board = board;
+        this->width = width;
+        this->height = height;
+        this->cell = std::clamp(std::min(width, height) / float(board), min_cell, max_cell);
+        this->center_x = float(board) / 2;
+        this->center_y = float(board) / 2;
+    }
+
+    /** \brief width of the view in cells
+     *
+     * @return number of cells along x
+     */
+    float view_width() const {
+        return width / cell;
+    }
+
+    /** \brief height of the view in cells
+     *
+     * @return number of cells along y
+     */
+    float view_height() const {
+        return height / cell;
+    }
+
+    /** \brief center view at cell
+     *
+     * View doesn't leave the board if the board is larger than the view,
+     * otherwise the board is centered.
+     *
+     * @param head - cell to follow
+     */
+    void follow(const Vector &head) {
+        center_x = clamp_center(float(head.x) + .5f, view_width());
+        center_y = clamp_center(float(head.y) + .5f, view_height());
+    }
+
+    /** \brief multiply cell size
+     *
+     * @param factor - zoom factor, >1 zooms in
+     */
+    void zoom(float factor) {
+        cell = std::clamp(cell * factor, min_cell, max_cell);
+        center_x = clamp_center(center_x, view_width());
+        center_y = clamp_center(center_y, view_height());
+    }
+
+    /** \brief cells that intersect the view
+     *
+     * @return range of visible cells clamped to the board
+     */
+    Cell_range visible() const {
+        Cell_range range{};
+        range.first_x = std::max(0, int(std::floor(center_x - view_width() / 2)));
+        range.last_x = std::min(board, int(std::ceil(center_x + view_width() / 2)));
+        range.first_y = std::max(0, int(std::floor(center_y - view_height() / 2)));
+        range.last_y = std::min(board, int(std::ceil(center_y + view_height() / 2)));
+        return range;
+    }
+
+private:
+    /** \brief keep view inside the board along one axis
+     *
+     * @param center - wanted center in cells
+     * @param view - view length in cells
+     * @return clamped center
+     */
+    float clamp_center(float center, float view) const {
+        if (view >= float(board))
+            return float(board) / 2;
+        return std::clamp(center, view / 2, float(board) - view / 2);
+    }
+};
+
+#endif //CPPPRJ_CAMERA_H
@@ -0,0 +1,251 @@
+#ifndef CPPPRJ_CHECKSUM_H
+#define CPPPRJ_CHECKSUM_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "Snake.h"
+#include "Bot.h"
+
+/** \brief mix bits of a 64-bit value, the splitmix64 finalizer
+ *
+ * @param value - value to mix
+ * @return mixed value
+ */
+inline std::uint64_t mix64(std::uint64_t value) {
+    value += 0x9e3779b97f4a7c15ull;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+    return value ^ (value >> 31);
+}
+
+/** \brief rolling checksum of a Basic_snake state.
+ *
+ * The grid part is the XOR of hashes of non-empty cells, so a move updates it from the
+ * few cells it can change: old tail, cell in front of the head, old and new apple.
+ * value() adds head, tail, length, directions and the next draw of the field's random
+ * engine. Body order isn't hashed, its cells are in the grid and a different order
+ * shows up in the next moves.
+ * The checksum is optional: games played without it are the same, move() and new_game()
+ * of the checksum call the game's ones.
+ */
+class State_checksum {
+public:
+    /** \brief checksum of the current state
+     *
+     * @tparam Game - Basic_snake on any field type
+     * @param game - game
+     */
+    template<class Game>
+    explicit State_checksum(const Game &game) {
+        reset(game);
+    }
+
+    /** \brief recompute the grid part from every cell
+     *
+     * @tparam Game - Basic_snake on any field type
+     * @param game - game
+     */
+    template<class Game>
+    void reset(const Game &game) {
+        this->size = game.field.size;
+        this->grid = 0;
+        for (int x = 0; x < size; x++)
+            for (int y = 0; y < size; y++)
+                grid ^= cell_hash(x, y, game.field.body[x][y]);
+    }
+
+    /** \brief move the game and update the grid part
+     *
+     * @tparam Game - Basic_snake on any field type
+     * @param game - game to move
+     * @return result of game.move()
+     */
+    template<class Game>
+    bool move(Game &game) {
+        Vector cells[3] = {game.body.back(), game.body[0] + game.delta, game.field.apple};
+        int before[3];
+        for (int k = 0; k < 3; k++)
+            before[k] = game.field.body[cells[k].x][cells[k].y];
+        bool working = game.move();
+        bool apple_seen = false;
+        for (int k = 0; k < 3; k++) {
+            bool repeated = false;
+            for (int other = 0; other < k; other++)
+                repeated = repeated or cells[other] == cells[k];
+            if (repeated)
+                continue;
+            apple_seen = apple_seen or cells[k] == game.field.apple;
+            grid ^= cell_hash(cells[k].x, cells[k].y, before[k]) ^
+                    cell_hash(cells[k].x, cells[k].y, game.field.body[cells[k].x][cells[k].y]);
+        }
+        //a new apple is placed on an empty cell
+        if (not apple_seen)
+            grid ^= cell_hash(game.field.apple.x, game.field.apple.y, Apple_id);
+        return working;
+    }
+
+    /** \brief restart the game and recompute the checksum
+     *
+     * @tparam Game - Basic_snake on any field type
+     * @param game - game to restart
+     * @return result of game.new_game()
+     */
+    template<class Game>
+    bool new_game(Game &game) {
+        bool started = game.new_game();
+        reset(game);
+        return started;
+    }
+
+    /** \brief checksum of the whole state
+     *
+     * @tparam Game - Basic_snake on any field type, the one this checksum follows
+     * @param game - game
+     * @return checksum
+     */
+    template<class Game>
+    std::uint64_t value(const Game &game) const {
+        auto engine = game.field.engine;
+        const std::int64_t parts[] = {game.body[0].x, game.body[0].y, game.body.back().x, game.body.back().y,
+                                      std::int64_t(game.body.size()), game.delta.x, game.delta.y,
+                                      game.last_delta.x, game.last_delta.y, std::int64_t(engine())};
+        std::uint64_t state = grid;
+        for (std::int64_t part : parts)
+            state = mix64(state ^ std::uint64_t(part));
+        return state;
+    }
+
+private:
+    ///size of the field
+    int size = 0;
+    ///XOR of hashes of non-empty cells
+    std::uint64_t grid = 0;
+
+    /** \brief hash of a cell with id, empty cells hash to 0
+     *
+     * @param x - column
+     * @param y - row
+     * @param id - cell id
+     * @return hash
+     */
+    std::uint64_t cell_hash(int x, int y, int id) const {
+        return id == Empty_id ? 0 : mix64((std::uint64_t(x) * std::uint64_t(size) + std::uint64_t(y)) * 4 + id);
+    }
+};
+
+/** \brief one tick of a bot game as snake_capture plays it
+ *
+ * The game and bot_engine are created with the same seed, so size and seed replay a game.
+ *
+ * @tparam Game - Basic_snake on any field type
+ * @param game - game
+ * @param bot_engine - random engine of the bot
+ * @param checksum - checksum following the game
+ */
+template<class Game>
+void play_bot_tick(Game &game, std::default_random_engine &bot_engine, State_checksum &checksum) {
+    bot_turn(game, bot_engine);
+    if (not checksum.move(game))
+        checksum.new_game(game);
+}
+
+/** \brief checksum stream of a bot game
+ *
+ * Text format: header "snake-checksums size S seed N", then "tick checksum" lines with
+ * the checksum in hex. Tick 0 is the state after construction.
+ */
+struct Checksum_stream {
+    ///size of the field
+    int size = 0;
+    ///seed of the game and the bot
+    unsigned seed = 0;
+    ///checksum of every tick
+    std::vector<std::uint64_t> values;
+};
+
+/** \brief write header of a checksum stream
+ *
+ * @param out - output file
+ * @param size - size of the field
+ * @param seed - seed of the game and the bot
+ * @return true if written
+ */
+inline bool write_checksum_header(std::FILE *out, int size, unsigned seed) {
+    return std::fprintf(out, "snake-checksums size %d seed %u\n", size, seed) > 0;
+}
+
+/** \brief write checksum of one tick
+ *
+ * @param out - output file
+ * @param tick - number of the tick
+ * @param value - checksum
+ * @return true if written
+ */
+inline bool write_checksum(std::FILE *out, long long tick, std::uint64_t value) {
+    return std::fprintf(out, "%lld %016llx\n", tick, (unsigned long long) value) > 0;
+}
+
+/** \brief read checksum stream
+ *
+ * @param in - input file
+ * @param stream - read stream
+ * @return true if the header is valid and ticks are consecutive from 0
+ */
+inline bool read_checksums(std::FILE *in, Checksum_stream &stream) {
+    stream.values.clear();
+    if (std::fscanf(in, " snake-checksums size %d seed %u", &stream.size, &stream.seed) != 2 or stream.size < 4)
+        return false;
+    long long tick;
+    unsigned long long value;
+    int read;
+    while ((read = std::fscanf(in, "%lld %llx", &tick, &value)) == 2) {
+        if (tick != (long long) stream.values.size())
+            return false;
+        stream.values.push_back(value);
+    }
+    return read == EOF;
+}
+
+/** \brief first tick where streams differ
+ *
+ * A stream that ends earlier differs at its end.
+ *
+ * @param first - first stream
+ * @param second - second stream
+ * @return tick of the first difference, -1 if the streams are equal
+ */
+inline long long first_divergence(const Checksum_stream &first, const Checksum_stream &second) {
+    std::size_t common = std::min(first.values.size(), second.values.size());
+    for (std::size_t tick = 0; tick < common; tick++)
+        if (first.values[tick] != second.values[tick])
+            return (long long) tick;
+    return first.values.size() == second.values.size() ? -1 : (long long) common;
+}
+
+/** \brief print state of a game
+ *
+ * Grid rows use '#' for walls, 'o' for the snake, '@' for its head, '*' for the apple.
+ *
+ * @tparam Game - Basic_snake on any field type
+ * @param out - output file
+ * @param game - game
+ */
+template<class Game>
+void dump_state(std::FILE *out, const Game &game) {
+    auto engine = game.field.engine;
+    std::fprintf(out, "head %d %d, tail %d %d, length %zu, delta %d %d, last delta %d %d, apple %d %d, next draw %llu\n",
+                 game.body[0].x, game.body[0].y, game.body.back().x, game.body.back().y, game.body.size(),
+                 game.delta.x, game.delta.y, game.last_delta.x, game.last_delta.y, game.field.apple.x,
+                 game.field.apple.y, (unsigned long long) engine());
+    static const char marks[] = {'.', '#', 'o', '*'};
+    for (int y = 0; y < game.field.size; y++) {
+        for (int x = 0; x < game.field.size; x++)
+            std::fputc(Vector(x, y) == game.body[0] ? '@' : marks[int(game.field.body[x][y])], out);
+        std::fputc('\n', out);
+    }
+}
+
+#endif //CPPPRJ_CHECKSUM_H
@@ -0,0 +1,149 @@
+#ifndef CPPPRJ_FIXED_FIELD_H
+#define CPPPRJ_FIXED_FIELD_H
+
+#include <array>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "Snake.h"
+
+/** \brief field object with the size known at compile time.
+ *
+ * Cells are kept in a std::array inside the object, so there is no allocation and
+ * every index and bound is a constant. Walls are built once at compile time and
+ * reset copies them over the whole board.
+ * Drop-in replacement of Field for Basic_snake with the same apple draws.
+ *
+ * @tparam N - size of the field
+ */
+template<int N>
+struct Fixed_field {
+public:
+    static_assert(N >= 4, "field must have cells inside the walls");
+    ///array of one column
+    using Column = std::array<unsigned char, N>;
+    ///Size of the field.
+    static constexpr int size = N;
+    ///[N * N] matrix of cell states
+    std::array<Column, N> body;
+    ///random engine for generating apples
+    std::default_random_engine engine;
+    ///cell of the last created apple
+    Vector apple;
+
+    /**\brief generates field N*N with fixed random seed.
+     *
+     * @param size - size of the field, must be N, kept for Basic_snake.
+     * @param seed - seed of random engine.
+     * @throws std::invalid_argument if the size isn't N
+     */
+    Fixed_field(int size, unsigned seed) : body(walls), engine(seed) {
+        if (size != N)
+            throw std::invalid_argument("Fixed_field size must equal its template size");
+    }
+
+    /** \brief creates apple at field
+     *
+     * Same draws as Field::create_apple().
+     */
+    void create_apple() {
+        std::uniform_int_distribution<int> x_distribution(1, N - 2);
+        std::uniform_int_distribution<int> y_distribution(1, N - 2);
+        int x = x_distribution(engine);
+        int y = y_distribution(engine);
+        while (body[x][y] != Empty_id) {
+            x = x_distribution(engine);
+            y = y_distribution(engine);
+        }
+        body[x][y] = Apple_id;
+        apple = Vector(x, y);
+    }
+
+    /** \brief makes every cell inside the walls empty
+     *
+     * Copies the compile-time board, the copy has constant length.
+     */
+    void clear() {
+        body = walls;
+    }
+
+    /** \brief makes every cell inside the walls empty if only parts and apple are occupied
+     *
+     * Same rule as Field::clear(parts), long snakes copy the empty board.
+     *
+     * @param parts - cells of the snake
+     */
+    void clear(const std::vector<Vector> &parts) {
+        if (parts.size() * Sparse_reset_ratio >= std::size_t(N - 2) * (N - 2)) {
+            clear();
+            return;
+        }
+        for (const Vector &part : parts)
+            body[part.x][part.y] = Empty_id;
+        if (body[apple.x][apple.y] == Apple_id)
+            body[apple.x][apple.y] = Empty_id;
+    }
+
+private:
+    /** \brief board with walls on the border and empty cells inside
+     *
+     * @return cells of the board
+     */
+    static constexpr std::array<Column, N> make_walls() {
+        std::array<Column, N> cells{};
+        for (int i = 0; i < N; i++)
+            for (int j = 0; j < N; j++)
+                cells[i][j] = i == 0 or j == 0 or i == N - 1 or j == N - 1 ? Wall_id : Empty_id;
+        return cells;
+    }
+
+    ///empty board built at compile time
+    static constexpr std::array<Column, N> walls = make_walls();
+};
+
+///snake game on a field of size fixed at compile time
+template<int N>
+using Fixed_snake = Basic_snake<Fixed_field<N>>;
+
+/** \brief run function with a game of size picked at run time
+ *
+ * Sizes 8, 10, 16, 32 and 64 get a Fixed_snake, other sizes get the reference Snake.
+ * The game is created inside and passed by reference, so it lives only during the call.
+ *
+ * @param size - size of the field
+ * @param seed - seed of field's random engine
+ * @param function - callable taking any Basic_snake by reference
+ * @return result of the function
+ */
+template<class Function>
+decltype(auto) with_snake(int size, unsigned seed, Function &&function) {
+    switch (size) {
+        case 8: {
+            Fixed_snake<8> game(size, seed);
+            return std::forward<Function>(function)(game);
+        }
+        case 10: {
+            Fixed_snake<10> game(size, seed);
+            return std::forward<Function>(function)(game);
+        }
+        case 16: {
+            Fixed_snake<16> game(size, seed);
+            return std::forward<Function>(function)(game);
+        }
+        case 32: {
+            Fixed_snake<32> game(size, seed);
+            return std::forward<Function>(function)(game);
+        }
+        case 64: {
+            Fixed_snake<64> game(size, seed);
+            return std::forward<Function>(function)(game);
+        }
+        default: {
+            Snake game(size, seed);
+            return std::forward<Function>(function)(game);
+        }
+    }
+}
+
+#endif //CPPPRJ_FIXED_FIELD_H
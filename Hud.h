@@ -0,0 +1,133 @@
+#ifndef CPPPRJ_HUD_H
+#define CPPPRJ_HUD_H
+
+#include <SFML/Graphics.hpp>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+/** \brief on-screen overlay with game and frame statistics.
+ *
+ * Glyphs of a built-in 3x5 pixel font are rasterized once into a texture.
+ * Quads of the text are rebuilt only when the shown text changes, and the overlay is drawn
+ * with one call, background included.
+ */
+class Hud {
+public:
+    ///number of times quads were rebuilt
+    long long rebuilds = 0;
+
+    /** \brief rasterize font
+     *
+     * @param scale - size of a font pixel in screen pixels
+     */
+    explicit Hud(float scale = 3.f) : quads(sf::Quads) {
+        this->scale = scale;
+        sf::Image image;
+        image.create(glyph_width * glyph_count, glyph_height, sf::Color(0, 0, 0, 0));
+        for (int k = 0; k < glyph_count; k++)
+            for (int y = 0; y < 5; y++)
+                for (int x = 0; x < 3; x++)
+                    if (glyph_rows[k][y] >> (2 - x) & 1)
+                        image.setPixel(unsigned(k * glyph_width + x), unsigned(y), sf::Color::White);
+        //solid glyph for the background
+        for (int y = 0; y < glyph_height; y++)
+            for (int x = 0; x < glyph_width; x++)
+                image.setPixel(unsigned(solid * glyph_width + x), unsigned(y), sf::Color::White);
+        font.loadFromImage(image);
+    }
+
+    /** \brief set shown values
+     *
+     * Quads are rebuilt only if the formatted text differs from the shown one.
+     *
+     * @param length - snake length
+     * @param ticks_per_second - game ticks per second
+     * @param fps - frames per second
+     * @param p50 - median frame time in milliseconds
+     * @param p99 - 99th percentile of frame time in milliseconds
+     */
+    void set(int length, double ticks_per_second, double fps, double p50, double p99) {
+        char line[96];
+        std::snprintf(line, sizeof(line), "LEN %d TPS %.1f FPS %.0f P50 %.2fMS P99 %.2fMS", length,
+                      ticks_per_second, fps, p50, p99);
+        if (text == line)
+            return;
+        text = line;
+        rebuild();
+    }
+
+    /** \brief push overlay to window
+     *
+     * Expects default view of the window.
+     *
+     * @param window - window for pushing overlay
+     */
+    void draw(sf::RenderWindow &window) const {
+        window.draw(quads, sf::RenderStates(&font));
+    }
+
+private:
+    ///width of glyph cell in the font texture
+    static constexpr int glyph_width = 4;
+    ///height of glyph cell in the font texture
+    static constexpr int glyph_height = 6;
+    ///characters of the font, solid block is the last glyph
+    static constexpr const char *characters = "0123456789EFLMNPST:./ ";
+    ///number of glyphs including solid block
+    static constexpr int glyph_count = 23;
+    ///index of solid block
+    static constexpr int solid = glyph_count - 1;
+    ///rows of 3 pixel wide glyphs, high bit is the left pixel
+    static constexpr unsigned char glyph_rows[glyph_count][5] = {
+            {7, 5, 5, 5, 7}, {2, 6, 2, 2, 7}, {7, 1, 7, 4, 7}, {7, 1, 7, 1, 7}, {5, 5, 7, 1, 1},
+            {7, 4, 7, 1, 7}, {7, 4, 7, 5, 7}, {7, 1, 1, 1, 1}, {7, 5, 7, 5, 7}, {7, 5, 7, 1, 7},
+            {7, 4, 7, 4, 7}, {7, 4, 7, 4, 4}, {4, 4, 4, 4, 7}, {5, 7, 7, 5, 5}, {7, 5, 5, 5, 5},
+            {7, 5, 7, 4, 4}, {7, 4, 7, 1, 7}, {7, 2, 2, 2, 2}, {0, 2, 0, 2, 0}, {0, 0, 0, 0, 2},
+            {1, 1, 2, 4, 4}, {0, 0, 0, 0, 0}, {0, 0, 0, 0, 0}};
+
+    ///size of a font pixel in screen pixels
+    float scale;
+    ///rasterized font
+    sf::Texture font;
+    ///quads of background and glyphs
+    sf::VertexArray quads;
+    ///shown text
+    std::string text;
+
+    /** \brief append textured quad
+     *
+     * @param x - left side in screen pixels
+     * @param y - top side in screen pixels
+     * @param glyph - index of glyph
+     * @param color - color of glyph pixels
+     * @param width - width in font pixels
+     */
+    void add_quad(float x, float y, int glyph, const sf::Color &color, float width) {
+        float u = float(glyph * glyph_width);
+        float right = x + width * scale, bottom = y + float(glyph_height) * scale;
+        float u_right = glyph == solid ? u + float(glyph_width) : u + width;
+        quads.append(sf::Vertex(sf::Vector2f(x, y), color, sf::Vector2f(u, 0)));
+        quads.append(sf::Vertex(sf::Vector2f(right, y), color, sf::Vector2f(u_right, 0)));
+        quads.append(sf::Vertex(sf::Vector2f(right, bottom), color, sf::Vector2f(u_right, glyph_height)));
+        quads.append(sf::Vertex(sf::Vector2f(x, bottom), color, sf::Vector2f(u, glyph_height)));
+    }
+
+    /** \brief build quads of the text
+     */
+    void rebuild() {
+        rebuilds++;
+        quads.clear();
+        float margin = 2 * scale;
+        add_quad(0, 0, solid, sf::Color(0, 0, 0, 160), float(text.size() * glyph_width) + 3);
+        for (std::size_t k = 0; k < text.size(); k++) {
+            const char *found = std::strchr(characters, text[k]);
+            if (found == nullptr or text[k] == ' ')
+                continue;
+            add_quad(margin + float(k * glyph_width) * scale, scale, int(found - characters), sf::Color::White,
+                     float(glyph_width));
+        }
+    }
+};
+
+#endif //CPPPRJ_HUD_H
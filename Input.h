@@ -0,0 +1,100 @@
+#ifndef CPPPRJ_INPUT_H
+#define CPPPRJ_INPUT_H
+
+#include <chrono>
+#include "Snake.h"
+#include "Stats.h"
+
+/** \brief one direction change requested by the player.
+ */
+struct Turn {
+    ///requested snake head displacement
+    Vector direction;
+    ///moment when the key event was received
+    std::chrono::steady_clock::time_point stamp;
+};
+
+/** \brief bounded queue of player's turns.
+ *
+ * Every key event is pushed with its timestamp, so turns made between two ticks are not lost.
+ * The engine takes one valid turn per tick, so two turns made in one tick are applied on
+ * two consecutive ticks instead of overwriting each other.
+ */
+class Input_queue {
+public:
+    ///maximal number of buffered turns
+    static constexpr int capacity = 4;
+    ///input-to-move latency of applied turns
+    Latency_stats latency;
+    ///number of turns dropped because the queue was full
+    long long dropped = 0;
+
+    /** \brief buffer a turn
+     *
+     * Turn is ignored if it repeats the last buffered one.
+     *
+     * @param direction - requested head displacement
+     * @param stamp - moment when the key event was received
+     * @return true if the turn was buffered
+     */
+    bool push(const Vector &direction, std::chrono::steady_clock::time_point stamp) {
+        if (count > 0 and turns[(first + count - 1) % capacity].direction == direction)
+            return false;
+        if (count == capacity) {
+            dropped++;
+            return false;
+        }
+        turns[(first + count) % capacity] = Turn{direction, stamp};
+        count++;
+        return true;
+    }
+
+    /** \brief apply one buffered turn to the snake
+     *
+     * Turns that would reverse the snake relative to its last_delta or keep its last_delta,
+     * like held or re-tapped keys, are discarded until a valid one is found, so they don't
+     * delay the next real turn. Call right before Snake::move().
+     *
+     * @param snake - Snake object
+     * @param now - moment of the move
+     * @return true if a turn was applied
+     */
+    bool apply(Snake &snake, std::chrono::steady_clock::time_point now) {
+        while (count > 0) {
+            Turn turn = turns[first];
+            first = (first + 1) % capacity;
+            count--;
+            if (turn.direction != snake.last_delta and snake.last_delta + turn.direction != Vector(0, 0)) {
+                snake.delta = turn.direction;
+                latency.add(now - turn.stamp);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** \brief number of buffered turns
+     *
+     * @return number of buffered turns
+     */
+    int size() const {
+        return count;
+    }
+
+    /** \brief drop all buffered turns
+     */
+    void clear() {
+        first = 0;
+        count = 0;
+    }
+
+private:
+    ///ring buffer of turns
+    Turn turns[capacity];
+    ///index of the oldest turn
+    int first = 0;
+    ///number of buffered turns
+    int count = 0;
+};
+
+#endif //CPPPRJ_INPUT_H
@@ -0,0 +1,160 @@
+#ifndef CPPPRJ_LINEAR_BOARD_H
+#define CPPPRJ_LINEAR_BOARD_H
+
+#include <algorithm>
+#include <vector>
+#include "Snake.h"
+
+/** \brief low-level snake board with linear cell indices.
+ *
+ * Cell (x, y) is cells[x * size + y], one byte per cell: bits 0-1 keep the cell id,
+ * bits 2-3 of a snake cell keep the direction code to the next part towards the head.
+ * Directions are offsets -1, +size, +1, -size, so advancing the head is one add and
+ * checking the next cell is one byte load. The head never leaves the board because
+ * the wall border stops every step, so there are no bounds checks.
+ * Apples are placed by the owner of the board.
+ */
+class Linear_board {
+public:
+    ///Size of the field, also the offset between columns.
+    int size;
+    ///[size * size] cells
+    std::vector<unsigned char> cells;
+    ///index offsets by direction code
+    int offsets[4];
+    ///index of the head
+    int head = 0;
+    ///index of the tail
+    int tail = 0;
+    ///number of snake parts
+    int length = 0;
+
+    /** \brief board with walls on the border and no snake
+     *
+     * @param size - size of the field
+     */
+    explicit Linear_board(int size) : cells(std::size_t(size) * size, Empty_id), offsets{-1, size, 1, -size} {
+        this->size = size;
+        for (int i = 0; i < size; i++)
+            for (int j = 0; j < size; j++)
+                if (i == 0 or j == 0 or i == size - 1 or j == size - 1)
+                    cells[index(i, j)] = Wall_id;
+    }
+
+    /** \brief index of cell
+     *
+     * @param x - column
+     * @param y - row
+     * @return index in cells
+     */
+    int index(int x, int y) const {
+        return x * size + y;
+    }
+
+    /** \brief cell of index
+     *
+     * @param k - index in cells
+     * @return cell vector
+     */
+    Vector position(int k) const {
+        return Vector(k / size, k % size);
+    }
+
+    /** \brief id of cell
+     *
+     * @param k - index in cells
+     * @return cell id
+     */
+    int at(int k) const {
+        return cells[k] & 3;
+    }
+
+    /** \brief makes every cell inside the walls empty
+     */
+    void clear() {
+        for (int i = 1; i < size - 1; i++)
+            std::fill(cells.begin() + index(i, 1), cells.begin() + index(i, size - 1), Empty_id);
+        length = 0;
+    }
+
+    /** \brief removes the snake and empties one more cell
+     *
+     * Walks the links from the tail, so the cost is proportional to the length.
+     * Long snakes clear the whole board instead. Other cells are left as they are.
+     *
+     * @param extra - index of a cell to empty if it holds an apple, like the last apple
+     */
+    void clear_snake(int extra) {
+        if (std::size_t(length) * Sparse_reset_ratio >= std::size_t(size - 2) * (size - 2)) {
+            clear();
+            return;
+        }
+        int part = tail;
+        for (int k = 0; k < length; k++) {
+            int next = part + offsets[cells[part] >> 2];
+            cells[part] = Empty_id;
+            part = next;
+        }
+        if (at(extra) == Apple_id)
+            cells[extra] = Empty_id;
+        length = 0;
+    }
+
+    /** \brief put snake of two parts with the head at (x, y) and the tail below it
+     *
+     * @param x - column of the head
+     * @param y - row of the head
+     */
+    void place(int x, int y) {
+        head = index(x, y);
+        tail = index(x, y + 1);
+        length = 2;
+        cells[head] = Snake_id;
+        cells[tail] = (unsigned char) (Snake_id | direction_code(Vector(0, -1)) << 2);
+    }
+
+    /** \brief move head one cell in direction if the cell is free
+     *
+     * Empty cell: tail and head move. Cell of the tail: same, the tail leaves it first.
+     * Apple: head moves, tail stays, length grows. Wall or other snake part: nothing changes.
+     *
+     * @param code - direction code
+     * @return id of the cell ahead, Empty_id for the cell of the tail
+     */
+    int step(int code) {
+        int next = head + offsets[code];
+        int id = cells[next] & 3;
+        if (id == Empty_id or (id == Snake_id and next == tail)) {
+            retract();
+            advance(code);
+            return Empty_id;
+        }
+        if (id == Apple_id) {
+            length++;
+            advance(code);
+        }
+        return id;
+    }
+
+    /** \brief free tail cell and follow its link
+     */
+    void retract() {
+        unsigned char &last = cells[tail];
+        int next = tail + offsets[last >> 2];
+        if ((last & 3) != Apple_id)
+            last = Empty_id;
+        tail = next;
+    }
+
+    /** \brief link head to the next cell and move it there
+     *
+     * @param code - direction code
+     */
+    void advance(int code) {
+        cells[head] = (unsigned char) (Snake_id | code << 2);
+        head += offsets[code];
+        cells[head] = Snake_id;
+    }
+};
+
+#endif //CPPPRJ_LINEAR_BOARD_H
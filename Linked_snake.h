@@ -0,0 +1,207 @@
+#ifndef CPPPRJ_LINKED_SNAKE_H
+#define CPPPRJ_LINKED_SNAKE_H
+
+#include <vector>
+#include <random>
+#include "Snake.h"
+#include "Linear_board.h"
+
+/** \brief compact snake engine with the body stored as links in the grid.
+ *
+ * Every cell is one byte: bits 0-1 keep the cell id, bits 2-3 of a snake cell keep
+ * the direction to the next part towards the head. Only head, tail and length are kept
+ * separately, so a move touches two cells and there is no body array.
+ * Cells and moves are the low-level Linear_board, this class adds directions and apples.
+ * Rules, random engine use and apple placement are the same as in Snake.
+ */
+class Linked_snake {
+public:
+    ///cells, head, tail and length of the snake
+    Linear_board board;
+    ///random engine for generating apples
+    std::default_random_engine engine;
+    ///Vector object that show snake head displacement after one move.
+    Vector delta;
+    ///Vector object that saves delta after move.
+    Vector last_delta;
+    ///index of the last created apple
+    int apple = 0;
+
+    /** \brief create game
+     *
+     * @param size - size of the field
+     */
+    explicit Linked_snake(int size) : Linked_snake(size, std::random_device()()) {}
+
+    /** \brief create game with fixed random seed
+     *
+     * @param size - size of the field
+     * @param seed - seed of random engine
+     */
+    Linked_snake(int size, unsigned seed) : board(size), engine(seed) {
+        start();
+    }
+
+    /** \brief id of cell
+     *
+     * @param x - column
+     * @param y - row
+     * @return cell id
+     */
+    int cell(int x, int y) const {
+        return board.at(board.index(x, y));
+    }
+
+    /** \brief cell of the head
+     *
+     * @return head vector
+     */
+    Vector head() const {
+        return board.position(board.head);
+    }
+
+    /** \brief number of snake parts
+     *
+     * @return length of the snake
+     */
+    int length() const {
+        return board.length;
+    }
+
+    /** \brief snake parts from head to tail
+     *
+     * Walks the links, meant for checks, not for the hot path.
+     *
+     * @return array of snake parts
+     */
+    std::vector<Vector> body() const {
+        std::vector<Vector> parts(board.length);
+        int part = board.tail;
+        for (int k = board.length - 1; k >= 0; k--) {
+            parts[k] = board.position(part);
+            part += board.offsets[board.cells[part] >> 2];
+        }
+        return parts;
+    }
+
+    /** \brief restart game
+     *
+     * @return true if game is restarted successfully
+     */
+    bool new_game() {
+        board.clear_snake(apple);
+        start();
+        return true;
+    }
+
+    /** \brief change direction to up if it wasn't down
+     */
+    void up() {
+        if (last_delta + Vector(0, -1) != Vector(0, 0))
+            delta = Vector(0, -1);
+    }
+
+    /** \brief change direction to right if it wasn't left
+     */
+    void right() {
+        if (last_delta + Vector(1, 0) != Vector(0, 0))
+            delta = Vector(1, 0);
+    }
+
+    /** \brief change direction to left if it wasn't right
+     */
+    void left() {
+        if (last_delta + Vector(-1, 0) != Vector(0, 0))
+            delta = Vector(-1, 0);
+    }
+
+    /** \brief change direction to down if it wasn't up
+     */
+    void down() {
+        if (last_delta + Vector(0, 1) != Vector(0, 0))
+            delta = Vector(0, 1);
+    }
+
+    /** \brief creates apple at field
+     *
+     * Same draws as Field::create_apple().
+     */
+    void create_apple() {
+        std::uniform_int_distribution<int> x_distribution(1, board.size - 2);
+        std::uniform_int_distribution<int> y_distribution(1, board.size - 2);
+        int x = x_distribution(engine);
+        int y = y_distribution(engine);
+        while (cell(x, y) != Empty_id) {
+            x = x_distribution(engine);
+            y = y_distribution(engine);
+        }
+        apple = board.index(x, y);
+        board.cells[apple] = Apple_id;
+    }
+
+    /** \brief move function that ignores obstacles.
+     *
+     * Tail follows its link and head gets a link to the new head.
+     */
+    void base_move() {
+        last_delta = delta;
+        board.retract();
+        board.advance(direction_code(delta));
+    }
+
+    /** \brief move and tell what happened.
+     *
+     * Same results as Snake::step(), from the code returned by Linear_board::step().
+     *
+     * @return event, eaten apple, length and apple after the step
+     */
+    Step_result step() {
+        Step_result result;
+        switch (board.step(direction_code(delta))) {
+            case Empty_id:
+                last_delta = delta;
+                result.event = Moved_event;
+                break;
+            case Apple_id:
+                last_delta = delta;
+                result.ate = true;
+                if (board.length < (board.size - 2) * (board.size - 2)) {
+                    create_apple();
+                    result.event = Ate_event;
+                } else
+                    result.event = Won_event;
+                break;
+            case Wall_id:
+                result.event = Wall_event;
+                break;
+            default:
+                result.event = Self_event;
+                break;
+        }
+        result.length = board.length;
+        result.apple = board.position(apple);
+        return result;
+    }
+
+    /** \brief default movement function.
+     *
+     * Same as step(), without the details.
+     *
+     * @return true if there wasn't obstacle, false otherwise
+     */
+    bool move() {
+        return step().working();
+    }
+
+private:
+    /** \brief place apple and snake of length 2 like Snake does
+     */
+    void start() {
+        delta = Vector(0, -1);
+        last_delta = delta;
+        board.place(board.size / 2, board.size / 2);
+        create_apple();
+    }
+};
+
+#endif //CPPPRJ_LINKED_SNAKE_H
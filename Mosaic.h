@@ -0,0 +1,150 @@
+#ifndef CPPPRJ_MOSAIC_H
+#define CPPPRJ_MOSAIC_H
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <vector>
+#include <cmath>
+#include <random>
+#include "Snake.h"
+#include "Bot.h"
+#include "Render.h"
+
+/** \brief many bot games laid out in a grid for spectating.
+ *
+ * All boards live in one vertex array drawn with the shared atlas in a single call.
+ * Every game moves once in ticks_every frames, games are staggered by index, so a frame
+ * moves about count / ticks_every games. Only boards that moved since the last draw are
+ * compared with the cached cell ids, and only quads of changed cells are rewritten.
+ */
+class Mosaic {
+public:
+    ///games shown in the mosaic
+    std::vector<Snake> games;
+    ///number of boards rewritten by the last draw
+    int updated_boards = 0;
+
+    /** \brief create games and their quads
+     *
+     * @param atlas - texture made from atlas_pixels
+     * @param count - number of games
+     * @param size - size of every field
+     * @param ticks_every - number of frames between two moves of a game
+     */
+    Mosaic(const sf::Texture &atlas, int count, int size, int ticks_every = 1) : atlas(&atlas), vertices(sf::Quads) {
+        this->size = size;
+        this->ticks_every = std::max(1, ticks_every);
+        this->columns = int(std::ceil(std::sqrt(double(count))));
+        std::random_device r;
+        this->engine = std::default_random_engine(r());
+        games.reserve(count);
+        for (int k = 0; k < count; k++)
+            games.emplace_back(size);
+        dirty.assign(count, true);
+        shown.assign(std::size_t(count) * size * size, Empty_id);
+        vertices.resize(shown.size() * 4);
+        for (int k = 0; k < count; k++)
+            for (int i = 0; i < size; i++)
+                for (int j = 0; j < size; j++)
+                    set_cell_quad(&vertices[index(k, i, j) * 4], origin_x(k) + float(i), origin_y(k) + float(j),
+                                  Empty_id);
+    }
+
+    /** \brief advance one frame, move games whose turn it is
+     *
+     * Game k moves on frames where (frame + k) % ticks_every is 0. Finished games are restarted.
+     */
+    void tick() {
+        for (std::size_t k = cycle; k < games.size(); k += ticks_every) {
+            bot_turn(games[k], engine);
+            if (not games[k].move())
+                games[k].new_game();
+            dirty[k] = true;
+        }
+        cycle = cycle == 0 ? ticks_every - 1 : cycle - 1;
+    }
+
+    /** \brief push all boards to window
+     *
+     * Window view is set to the whole mosaic.
+     *
+     * @param window - window for pushing boards
+     */
+    void draw(sf::RenderWindow &window) {
+        updated_boards = 0;
+        for (std::size_t k = 0; k < games.size(); k++) {
+            if (not dirty[k])
+                continue;
+            dirty[k] = false;
+            updated_boards++;
+            const Field &field = games[k].field;
+            for (int i = 0; i < size; i++) {
+                for (int j = 0; j < size; j++) {
+                    std::size_t cell = index(int(k), i, j);
+                    if (shown[cell] != field.body[i][j]) {
+                        shown[cell] = (unsigned char) field.body[i][j];
+                        set_cell_quad(&vertices[cell * 4], origin_x(int(k)) + float(i), origin_y(int(k)) + float(j),
+                                      field.body[i][j]);
+                    }
+                }
+            }
+        }
+        float extent = float(columns * (size + 1) - 1);
+        sf::View view;
+        view.setCenter(extent / 2, extent / 2);
+        view.setSize(extent, extent);
+        window.setView(view);
+        window.draw(vertices, sf::RenderStates(atlas));
+    }
+
+private:
+    ///atlas texture
+    const sf::Texture *atlas;
+    ///quads of all cells of all boards
+    sf::VertexArray vertices;
+    ///cell ids currently written to vertices
+    std::vector<unsigned char> shown;
+    ///true for boards that moved since last draw
+    std::vector<bool> dirty;
+    ///random engine of the bots
+    std::default_random_engine engine;
+    ///size of every field
+    int size;
+    ///number of frames between two moves of a game
+    int ticks_every;
+    ///first game moved by the next tick()
+    int cycle = 0;
+    ///number of boards in one row of the mosaic
+    int columns;
+
+    /** \brief index of cell in shown
+     *
+     * @param k - index of the game
+     * @param i - column of the cell
+     * @param j - row of the cell
+     * @return linear index
+     */
+    std::size_t index(int k, int i, int j) const {
+        return (std::size_t(k) * size + i) * size + j;
+    }
+
+    /** \brief left side of the board, boards are separated by one cell
+     *
+     * @param k - index of the game
+     * @return x position in cell units
+     */
+    float origin_x(int k) const {
+        return float(k % columns * (size + 1));
+    }
+
+    /** \brief top side of the board
+     *
+     * @param k - index of the game
+     * @return y position in cell units
+     */
+    float origin_y(int k) const {
+        return float(k / columns * (size + 1));
+    }
+};
+
+#endif //CPPPRJ_MOSAIC_H
@@ -0,0 +1,369 @@
+#ifndef CPPPRJ_PACKED_FIELD_H
+#define CPPPRJ_PACKED_FIELD_H
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "Snake.h"
+
+/** \brief square grid of cell ids packed 2 bits per cell.
+ *
+ * Cell (x, y) is cell number x * size + y, 32 cells are kept in one 64-bit word.
+ * Bits after the last cell are always zero. Bulk operations work on whole words.
+ */
+class Packed_grid {
+public:
+    ///cells in one word
+    static constexpr int cells_per_word = 32;
+
+    /** \brief reference to one cell, converts to id and assigns id
+     */
+    class Cell {
+    public:
+        /** \brief bind cell
+         *
+         * @param grid - grid of the cell
+         * @param k - number of the cell
+         */
+        Cell(Packed_grid &grid, std::size_t k) : grid(grid), k(k) {}
+
+        Cell(const Cell &) = default;
+
+        /** \brief id of the cell
+         *
+         * @return cell id
+         */
+        operator int() const {
+            return grid.get(k);
+        }
+
+        /** \brief set id of the cell
+         *
+         * @param id - cell id
+         * @return this cell
+         */
+        Cell &operator=(int id) {
+            grid.set(k, id);
+            return *this;
+        }
+
+        /** \brief copy id of other cell
+         *
+         * @param other - cell to copy
+         * @return this cell
+         */
+        Cell &operator=(const Cell &other) {
+            grid.set(k, int(other));
+            return *this;
+        }
+
+    private:
+        ///grid of the cell
+        Packed_grid &grid;
+        ///number of the cell
+        std::size_t k;
+    };
+
+    /** \brief one column x of the grid, indexed by y
+     */
+    class Column {
+    public:
+        /** \brief bind column
+         *
+         * @param grid - grid of the column
+         * @param x - column
+         */
+        Column(Packed_grid &grid, int x) : grid(grid), x(x) {}
+
+        /** \brief cell of the column
+         *
+         * @param y - row
+         * @return cell reference
+         */
+        Cell operator[](int y) const {
+            return Cell(grid, std::size_t(x) * grid.side + y);
+        }
+
+        /** \brief length of the column
+         *
+         * @return size of the grid
+         */
+        std::size_t size() const {
+            return grid.size();
+        }
+
+    private:
+        ///grid of the column
+        Packed_grid &grid;
+        ///column
+        int x;
+    };
+
+    /** \brief read-only column x of the grid, indexed by y
+     */
+    class Const_column {
+    public:
+        /** \brief bind column
+         *
+         * @param grid - grid of the column
+         * @param x - column
+         */
+        Const_column(const Packed_grid &grid, int x) : grid(grid), x(x) {}
+
+        /** \brief cell of the column
+         *
+         * @param y - row
+         * @return cell id
+         */
+        int operator[](int y) const {
+            return grid.get(std::size_t(x) * grid.side + y);
+        }
+
+        /** \brief length of the column
+         *
+         * @return size of the grid
+         */
+        std::size_t size() const {
+            return grid.size();
+        }
+
+    private:
+        ///grid of the column
+        const Packed_grid &grid;
+        ///column
+        int x;
+    };
+
+    /** \brief empty grid
+     *
+     * @param size - size of the grid
+     */
+    explicit Packed_grid(int size = 0) : words((std::size_t(size) * size + cells_per_word - 1) / cells_per_word) {
+        this->side = size;
+    }
+
+    /** \brief column of the grid
+     *
+     * @param x - column
+     * @return column proxy indexed by row
+     */
+    Column operator[](int x) {
+        return Column(*this, x);
+    }
+
+    /** \brief column of the grid
+     *
+     * @param x - column
+     * @return column proxy indexed by row
+     */
+    Const_column operator[](int x) const {
+        return Const_column(*this, x);
+    }
+
+    /** \brief number of columns
+     *
+     * @return size of the grid
+     */
+    std::size_t size() const {
+        return std::size_t(side);
+    }
+
+    /** \brief id of cell
+     *
+     * @param k - number of the cell
+     * @return cell id
+     */
+    int get(std::size_t k) const {
+        return int(words[k / cells_per_word] >> (k % cells_per_word * 2) & 3);
+    }
+
+    /** \brief set id of cell
+     *
+     * @param k - number of the cell
+     * @param id - cell id
+     */
+    void set(std::size_t k, int id) {
+        std::uint64_t &word = words[k / cells_per_word];
+        unsigned shift = unsigned(k % cells_per_word * 2);
+        word = (word & ~(std::uint64_t(3) << shift)) | std::uint64_t(id) << shift;
+    }
+
+    /** \brief set id of cells [begin, end) word by word
+     *
+     * @param begin - number of the first cell
+     * @param end - number after the last cell
+     * @param id - cell id
+     */
+    void fill(std::size_t begin, std::size_t end, int id) {
+        std::uint64_t pattern = std::uint64_t(id) * 0x5555555555555555ull;
+        while (begin < end) {
+            std::size_t w = begin / cells_per_word;
+            std::size_t first = begin % cells_per_word;
+            std::size_t last = std::min<std::size_t>(cells_per_word, first + (end - begin));
+            std::uint64_t mask = last - first == cells_per_word ? ~std::uint64_t(0)
+                                                                : ((std::uint64_t(1) << (2 * (last - first))) - 1) << (2 * first);
+            words[w] = (words[w] & ~mask) | (pattern & mask);
+            begin += last - first;
+        }
+    }
+
+    /** \brief walls on the border, empty cells inside
+     */
+    void reset() {
+        fill(0, std::size_t(side) * side, Empty_id);
+        fill(0, std::size_t(side), Wall_id);
+        fill(std::size_t(side - 1) * side, std::size_t(side) * side, Wall_id);
+        for (int x = 1; x < side - 1; x++) {
+            set(std::size_t(x) * side, Wall_id);
+            set(std::size_t(x) * side + side - 1, Wall_id);
+        }
+    }
+
+    /** \brief makes every cell inside the walls empty
+     */
+    void clear_interior() {
+        for (int x = 1; x < side - 1; x++)
+            fill(std::size_t(x) * side + 1, std::size_t(x) * side + side - 1, Empty_id);
+    }
+
+    /** \brief number of cells with id
+     *
+     * @param id - cell id
+     * @return number of cells
+     */
+    long long count(int id) const {
+        const std::uint64_t low = 0x5555555555555555ull;
+        std::size_t cells = std::size_t(side) * side;
+        long long total = 0;
+        for (std::size_t w = 0; w < words.size(); w++) {
+            std::uint64_t lo = words[w] & low, hi = words[w] >> 1 & low;
+            std::uint64_t match = (id & 1 ? lo : ~lo) & (id & 2 ? hi : ~hi) & low;
+            std::size_t valid = std::min<std::size_t>(cells_per_word, cells - w * cells_per_word);
+            if (valid < cells_per_word)
+                match &= (std::uint64_t(1) << (2 * valid)) - 1;
+            total += popcount(match);
+        }
+        return total;
+    }
+
+    /** \brief equality of two grids
+     *
+     * @param other - grid to compare
+     * @return true if sizes and all cells are equal
+     */
+    bool operator==(const Packed_grid &other) const {
+        return side == other.side and words == other.words;
+    }
+
+    /** \brief inequality of two grids
+     *
+     * @param other - grid to compare
+     * @return true if sizes or some cells differ
+     */
+    bool operator!=(const Packed_grid &other) const {
+        return not(*this == other);
+    }
+
+    /** \brief memory used by cells
+     *
+     * @return number of bytes of packed words
+     */
+    std::size_t bytes() const {
+        return words.size() * sizeof(std::uint64_t);
+    }
+
+private:
+    ///packed cells
+    std::vector<std::uint64_t> words;
+    ///size of the grid
+    int side;
+
+    /** \brief number of set bits
+     *
+     * @param word - word
+     * @return number of set bits
+     */
+    static int popcount(std::uint64_t word) {
+#if defined(__GNUC__) or defined(__clang__)
+        return __builtin_popcountll(word);
+#else
+        int total = 0;
+        for (; word != 0; word &= word - 1)
+            total++;
+        return total;
+#endif
+    }
+};
+
+/** \brief field object with cells packed 2 bits per cell.
+ *
+ * Drop-in replacement of Field for Basic_snake: same walls, same apple placement
+ * for the same seed, body[x][y] reads and writes ids through the packed grid.
+ */
+struct Packed_field {
+public:
+    ///Size of the field.
+    int size;
+    ///packed [size * size] matrix of cell states
+    Packed_grid body;
+    ///random engine for generating apples
+    std::default_random_engine engine;
+    ///cell of the last created apple
+    Vector apple;
+
+    /**\brief generates field size*size with fixed random seed.
+     *
+     * @param size - size of the field.
+     * @param seed - seed of random engine.
+     */
+    Packed_field(int size, unsigned seed) : body(size), engine(seed) {
+        this->size = size;
+        body.reset();
+    }
+
+    /** \brief creates apple at field
+     *
+     * Same draws as Field::create_apple().
+     */
+    void create_apple() {
+        std::uniform_int_distribution<int> x_distribution(1, size - 2);
+        std::uniform_int_distribution<int> y_distribution(1, size - 2);
+        int x = x_distribution(engine);
+        int y = y_distribution(engine);
+        while (body.get(std::size_t(x) * size + y) != Empty_id) {
+            x = x_distribution(engine);
+            y = y_distribution(engine);
+        }
+        body.set(std::size_t(x) * size + y, Apple_id);
+        apple = Vector(x, y);
+    }
+
+    /** \brief makes every cell inside the walls empty
+     */
+    void clear() {
+        body.clear_interior();
+    }
+
+    /** \brief makes every cell inside the walls empty if only parts and apple are occupied
+     *
+     * Same rule as Field::clear(parts), long snakes clear word by word.
+     *
+     * @param parts - cells of the snake
+     */
+    void clear(const std::vector<Vector> &parts) {
+        if (parts.size() * Sparse_reset_ratio >= std::size_t(size - 2) * (size - 2)) {
+            clear();
+            return;
+        }
+        for (const Vector &part : parts)
+            body.set(std::size_t(part.x) * size + part.y, Empty_id);
+        if (body.get(std::size_t(apple.x) * size + apple.y) == Apple_id)
+            body.set(std::size_t(apple.x) * size + apple.y, Empty_id);
+    }
+};
+
+///snake game on the packed field
+using Packed_snake = Basic_snake<Packed_field>;
+
+#endif //CPPPRJ_PACKED_FIELD_H
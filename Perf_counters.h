@@ -0,0 +1,189 @@
+#ifndef CPPPRJ_PERF_COUNTERS_H
+#define CPPPRJ_PERF_COUNTERS_H
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+#ifdef __linux__
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/** \brief hardware event counts, negative values are events that couldn't be counted
+ */
+struct Perf_counts {
+    ///CPU cycles
+    double cycles = -1;
+    ///retired instructions
+    double instructions = -1;
+    ///L1 data cache read misses
+    double l1_misses = -1;
+    ///last level cache misses
+    double llc_misses = -1;
+    ///mispredicted branches
+    double branch_misses = -1;
+
+    /** \brief check if anything was counted
+     *
+     * @return true if at least one event was counted
+     */
+    bool any() const {
+        return cycles >= 0 or instructions >= 0 or l1_misses >= 0 or llc_misses >= 0 or branch_misses >= 0;
+    }
+
+    /** \brief instructions per cycle
+     *
+     * @return IPC, negative if cycles or instructions weren't counted
+     */
+    double ipc() const {
+        return cycles > 0 and instructions >= 0 ? instructions / cycles : -1.;
+    }
+
+    /** \brief add counts of another run, an event stays uncounted if it is missing in either
+     *
+     * @param other - counts of another run
+     */
+    void add(const Perf_counts &other) {
+        for (auto member : {&Perf_counts::cycles, &Perf_counts::instructions, &Perf_counts::l1_misses,
+                            &Perf_counts::llc_misses, &Perf_counts::branch_misses})
+            this->*member = this->*member < 0 or other.*member < 0 ? -1. : this->*member + other.*member;
+    }
+
+    /** \brief counts divided by number of operations, uncounted events stay negative
+     *
+     * @param operations - number of operations, positive
+     * @return counts of one operation
+     */
+    Perf_counts per(double operations) const {
+        Perf_counts counts = *this;
+        for (auto member : {&Perf_counts::cycles, &Perf_counts::instructions, &Perf_counts::l1_misses,
+                            &Perf_counts::llc_misses, &Perf_counts::branch_misses})
+            if (counts.*member >= 0)
+                counts.*member /= operations;
+        return counts;
+    }
+};
+
+/** \brief hardware counters of the calling thread read with perf_event_open.
+ *
+ * Every event is opened on its own, so a CPU or a container that lacks some of them
+ * still counts the rest. Kernel and hypervisor time isn't counted, that is what an
+ * unprivileged process may count with perf_event_paranoid 2.
+ * If the kernel multiplexes the counters, counts are scaled by enabled / running time.
+ * On other systems or without permission nothing is counted and all calls do nothing.
+ */
+class Perf_counters {
+public:
+    /** \brief open counters of the calling thread, they are stopped
+     */
+    Perf_counters() {
+        descriptors.fill(-1);
+#ifdef __linux__
+        const std::array<std::pair<std::uint32_t, std::uint64_t>, Event_count> events = {{
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+                {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                     (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}}};
+        for (int k = 0; k < Event_count; k++) {
+            perf_event_attr attributes;
+            std::memset(&attributes, 0, sizeof(attributes));
+            attributes.size = sizeof(attributes);
+            attributes.type = events[k].first;
+            attributes.config = events[k].second;
+            attributes.disabled = 1;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            descriptors[k] = int(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+        }
+#endif
+    }
+
+    Perf_counters(const Perf_counters &) = delete;
+
+    Perf_counters &operator=(const Perf_counters &) = delete;
+
+    /** \brief close counters
+     */
+    ~Perf_counters() {
+#ifdef __linux__
+        for (int descriptor : descriptors)
+            if (descriptor >= 0)
+                close(descriptor);
+#endif
+    }
+
+    /** \brief check if any event can be counted
+     *
+     * @return true if at least one counter is open
+     */
+    bool available() const {
+        for (int descriptor : descriptors)
+            if (descriptor >= 0)
+                return true;
+        return false;
+    }
+
+    /** \brief reset counters to zero and start them
+     */
+    void start() {
+#ifdef __linux__
+        for (int descriptor : descriptors)
+            if (descriptor >= 0) {
+                ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+                ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+    }
+
+    /** \brief stop counters, counts are kept until the next start()
+     */
+    void stop() {
+#ifdef __linux__
+        for (int descriptor : descriptors)
+            if (descriptor >= 0)
+                ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+#endif
+    }
+
+    /** \brief counts since the last start()
+     *
+     * @return counts, events that can't be counted or weren't scheduled are negative
+     */
+    Perf_counts read() const {
+        std::array<double, Event_count> values;
+        values.fill(-1);
+#ifdef __linux__
+        for (int k = 0; k < Event_count; k++) {
+            std::uint64_t data[3];
+            if (descriptors[k] < 0 or ::read(descriptors[k], data, sizeof(data)) != ssize_t(sizeof(data)) or
+                data[2] == 0)
+                continue;
+            values[k] = double(data[0]) * (double(data[1]) / double(data[2]));
+        }
+#endif
+        Perf_counts counts;
+        counts.cycles = values[Cycles];
+        counts.instructions = values[Instructions];
+        counts.l1_misses = values[L1_misses];
+        counts.llc_misses = values[Llc_misses];
+        counts.branch_misses = values[Branch_misses];
+        return counts;
+    }
+
+private:
+    ///counted events, index of descriptors
+    enum Event {
+        Cycles, Instructions, L1_misses, Llc_misses, Branch_misses, Event_count
+    };
+    ///file descriptor of every event, -1 if it isn't counted
+    std::array<int, Event_count> descriptors;
+};
+
+#endif //CPPPRJ_PERF_COUNTERS_H
@@ -0,0 +1,212 @@
+#ifndef CPPPRJ_RASTER_H
+#define CPPPRJ_RASTER_H
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "Snake.h"
+#include "Workers.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/** \brief copy pixel row
+ *
+ * Copies 16 bytes per instruction when SSE2 is available.
+ *
+ * @param destination - row to write
+ * @param source - row to read
+ * @param bytes - length of the row in bytes
+ */
+inline void copy_row(unsigned char *destination, const unsigned char *source, int bytes) {
+#ifdef __SSE2__
+    for (; bytes >= 16; bytes -= 16, destination += 16, source += 16)
+        _mm_storeu_si128((__m128i *) destination, _mm_loadu_si128((const __m128i *) source));
+#endif
+    std::memcpy(destination, source, std::size_t(bytes));
+}
+
+/** \brief RGB tiles of cells scaled to the frame cell size.
+ *
+ * Tiles are taken from an RGBA atlas once, so rendering only copies rows.
+ */
+struct Tile_set {
+    ///cell size in pixels
+    int cell;
+    ///RGB pixels of tiles in the order of cell ids, cell * cell pixels each
+    std::vector<unsigned char> pixels;
+
+    /** \brief scale atlas tiles of cells with nearest sampling
+     *
+     * @param atlas - RGBA pixels of atlas
+     * @param atlas_width - width of atlas in pixels
+     * @param rects - left, top, width, height of the tiles in the order of cell ids
+     * @param cell - cell size in pixels
+     */
+    Tile_set(const unsigned char *atlas, unsigned atlas_width, const unsigned (*rects)[4], int cell) {
+        this->cell = cell;
+        pixels.resize(std::size_t(4) * cell * cell * 3);
+        for (int id = Empty_id; id <= Apple_id; id++) {
+            for (int y = 0; y < cell; y++) {
+                for (int x = 0; x < cell; x++) {
+                    unsigned u = rects[id][0] + unsigned(x) * rects[id][2] / unsigned(cell);
+                    unsigned v = rects[id][1] + unsigned(y) * rects[id][3] / unsigned(cell);
+                    const unsigned char *source = atlas + (std::size_t(v) * atlas_width + u) * 4;
+                    unsigned char *destination = &pixels[((std::size_t(id) * cell + y) * cell + x) * 3];
+                    destination[0] = source[0];
+                    destination[1] = source[1];
+                    destination[2] = source[2];
+                }
+            }
+        }
+    }
+
+    /** \brief pixel row of tile
+     *
+     * @param id - cell id
+     * @param y - row inside the tile
+     * @return pointer to cell * 3 bytes
+     */
+    const unsigned char *row(int id, int y) const {
+        return &pixels[(std::size_t(id) * cell + y) * cell * 3];
+    }
+};
+
+/** \brief CPU renderer of Field into RGB framebuffer.
+ *
+ * Works without display. Frame is size * cell pixels wide and high, x axis of the image
+ * is the first index of Field::body like in the window. Rows of cells are split between
+ * worker threads.
+ */
+class Rasterizer {
+public:
+    ///tiles of cells
+    const Tile_set &tiles;
+
+    /** \brief create rasterizer
+     *
+     * @param tiles - tiles of cells
+     * @param threads - number of background threads for large frames
+     */
+    explicit Rasterizer(const Tile_set &tiles, int threads = 0) : tiles(tiles), workers(threads) {}
+
+    /** \brief frame side in pixels
+     *
+     * @param field - field to render
+     * @return width and height of the frame
+     */
+    int frame_size(const Field &field) const {
+        return field.size * tiles.cell;
+    }
+
+    /** \brief render field
+     *
+     * @param field - field to render
+     * @param frame - RGB buffer of frame_size(field)^2 pixels
+     */
+    void render(const Field &field, unsigned char *frame) {
+        current = &field;
+        target = frame;
+        workers.parallel_for(field.size, [this](int begin, int end) {
+            render_rows(*current, target, begin, end);
+        });
+    }
+
+private:
+    ///threads rendering cell rows
+    Workers workers;
+    ///field of the frame being rendered
+    const Field *current = nullptr;
+    ///buffer of the frame being rendered
+    unsigned char *target = nullptr;
+
+    /** \brief render cell rows [begin, end)
+     *
+     * @param field - field to render
+     * @param frame - RGB buffer of frame
+     * @param begin - first cell row
+     * @param end - cell row after the last one
+     */
+    void render_rows(const Field &field, unsigned char *frame, int begin, int end) const {
+        int cell = tiles.cell;
+        int bytes = cell * 3;
+        std::size_t stride = std::size_t(field.size) * bytes;
+        for (int j = begin; j < end; j++) {
+            unsigned char *band = frame + std::size_t(j) * cell * stride;
+            for (int i = 0; i < field.size; i++) {
+                int id = field.body[i][j];
+                for (int y = 0; y < cell; y++)
+                    copy_row(band + y * stride + std::size_t(i) * bytes, tiles.row(id, y), bytes);
+            }
+        }
+    }
+};
+
+/** \brief write frame as binary PPM image
+ *
+ * Consecutive images form a stream that ffmpeg reads with -f image2pipe -c:v ppm.
+ *
+ * @param out - file or pipe
+ * @param width - frame width in pixels
+ * @param height - frame height in pixels
+ * @param frame - RGB pixels
+ * @return true if everything is written
+ */
+inline bool write_ppm(std::FILE *out, int width, int height, const unsigned char *frame) {
+    std::fprintf(out, "P6\n%d %d\n255\n", width, height);
+    std::size_t bytes = std::size_t(width) * height * 3;
+    return std::fwrite(frame, 1, bytes, out) == bytes;
+}
+
+/** \brief writer of YUV4MPEG2 (Y4M) video with 4:4:4 sampling.
+ *
+ * Converts RGB frames with BT.601 coefficients into a reused plane buffer.
+ */
+class Y4m_writer {
+public:
+    /** \brief write stream header
+     *
+     * @param out - file or pipe
+     * @param width - frame width in pixels
+     * @param height - frame height in pixels
+     * @param fps - frames per second written to the header
+     */
+    Y4m_writer(std::FILE *out, int width, int height, int fps = 30) {
+        this->out = out;
+        this->width = width;
+        this->height = height;
+        planes.resize(std::size_t(width) * height * 3);
+        std::fprintf(out, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n", width, height, fps);
+    }
+
+    /** \brief write one frame
+     *
+     * @param frame - RGB pixels
+     * @return true if everything is written
+     */
+    bool write(const unsigned char *frame) {
+        std::size_t pixels = std::size_t(width) * height;
+        unsigned char *y = planes.data(), *u = y + pixels, *v = u + pixels;
+        for (std::size_t k = 0; k < pixels; k++) {
+            int r = frame[k * 3], g = frame[k * 3 + 1], b = frame[k * 3 + 2];
+            y[k] = (unsigned char) ((66 * r + 129 * g + 25 * b + 128) / 256 + 16);
+            u[k] = (unsigned char) ((-38 * r - 74 * g + 112 * b + 128) / 256 + 128);
+            v[k] = (unsigned char) ((112 * r - 94 * g - 18 * b + 128) / 256 + 128);
+        }
+        std::fputs("FRAME\n", out);
+        return std::fwrite(planes.data(), 1, planes.size(), out) == planes.size();
+    }
+
+private:
+    ///file or pipe
+    std::FILE *out;
+    ///frame width in pixels
+    int width;
+    ///frame height in pixels
+    int height;
+    ///Y, U and V planes of the frame
+    std::vector<unsigned char> planes;
+};
+
+#endif //CPPPRJ_RASTER_H
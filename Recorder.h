@@ -0,0 +1,178 @@
+#ifndef CPPPRJ_RECORDER_H
+#define CPPPRJ_RECORDER_H
+
+#include <condition_variable>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Raster.h"
+
+/** \brief framebuffer handed from the game thread to the encoder.
+ */
+struct Frame {
+    ///RGB pixels
+    std::vector<unsigned char> pixels;
+    ///frame width in pixels
+    int width = 0;
+    ///frame height in pixels
+    int height = 0;
+    ///number of the frame, used in file name
+    long long index = 0;
+};
+
+/** \brief recording pipeline that encodes frames off the game thread.
+ *
+ * Frames come from a fixed pool allocated once and return to it after encoding.
+ * The game thread only fills a free frame and queues it, worker threads encode.
+ * When all frames are busy the encoder is overloaded and new frames are dropped,
+ * so the game thread never waits.
+ */
+class Recorder {
+public:
+    ///function that encodes frame, returns false on error
+    using Encoder = std::function<bool(const Frame &)>;
+    ///number of encoded frames
+    long long written = 0;
+    ///number of frames dropped under overload
+    long long dropped = 0;
+    ///number of frames that failed to encode
+    long long failed = 0;
+
+    /** \brief allocate frame pool and start encoder threads
+     *
+     * @param width - frame width in pixels
+     * @param height - frame height in pixels
+     * @param encode - function that encodes frame
+     * @param pool_size - number of frames in pool
+     * @param threads - number of encoder threads
+     */
+    Recorder(int width, int height, Encoder encode, int pool_size = 8, int threads = 2)
+            : frames(pool_size), encode(std::move(encode)) {
+        for (auto &frame : frames) {
+            frame.pixels.resize(std::size_t(width) * height * 3);
+            frame.width = width;
+            frame.height = height;
+            free.push_back(&frame);
+        }
+        queue.reserve(frames.size());
+        for (int i = 0; i < threads; i++)
+            workers.emplace_back([this] { work(); });
+    }
+
+    Recorder(const Recorder &) = delete;
+
+    Recorder &operator=(const Recorder &) = delete;
+
+    /** \brief encode queued frames and stop encoder threads
+     */
+    ~Recorder() {
+        finish();
+    }
+
+    /** \brief encode queued frames and stop encoder threads
+     *
+     * Counters are final after this call.
+     */
+    void finish() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        ready.notify_all();
+        for (auto &worker : workers)
+            worker.join();
+        workers.clear();
+    }
+
+    /** \brief take free frame without waiting
+     *
+     * @param index - number of the frame
+     * @return frame to fill or nullptr if the frame is dropped
+     */
+    Frame *acquire(long long index) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (free.empty()) {
+            dropped++;
+            return nullptr;
+        }
+        Frame *frame = free.back();
+        free.pop_back();
+        frame->index = index;
+        return frame;
+    }
+
+    /** \brief queue filled frame for encoding
+     *
+     * @param frame - frame returned by acquire()
+     */
+    void submit(Frame *frame) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back(frame);
+        }
+        ready.notify_one();
+    }
+
+private:
+    ///pool of frames
+    std::vector<Frame> frames;
+    ///frames that can be filled
+    std::vector<Frame *> free;
+    ///frames waiting for encoder, the pool bounds its size
+    std::vector<Frame *> queue;
+    ///encoder threads
+    std::vector<std::thread> workers;
+    ///function that encodes frame
+    Encoder encode;
+    ///guards free, queue and counters
+    std::mutex mutex;
+    ///signals queued frame or stop
+    std::condition_variable ready;
+    ///true when threads must exit after the queue is empty
+    bool stop = false;
+
+    /** \brief loop of encoder thread
+     */
+    void work() {
+        while (true) {
+            Frame *frame;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                ready.wait(lock, [this] { return stop or not queue.empty(); });
+                if (queue.empty())
+                    return;
+                frame = queue.front();
+                queue.erase(queue.begin());
+            }
+            bool ok = encode(*frame);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (ok)
+                written++;
+            else
+                failed++;
+            free.push_back(frame);
+        }
+    }
+};
+
+/** \brief encoder that writes every frame to its own PPM file
+ *
+ * @param directory - existing directory for frames
+ * @return encoder writing directory/frame_{index}.ppm
+ */
+inline Recorder::Encoder ppm_files(const std::string &directory) {
+    return [directory](const Frame &frame) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "/frame_%06lld.ppm", frame.index);
+        std::FILE *out = std::fopen((directory + name).c_str(), "wb");
+        if (out == nullptr)
+            return false;
+        bool ok = write_ppm(out, frame.width, frame.height, frame.pixels.data());
+        return std::fclose(out) == 0 and ok;
+    };
+}
+
+#endif //CPPPRJ_RECORDER_H
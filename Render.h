@@ -0,0 +1,142 @@
+#ifndef CPPPRJ_RENDER_H
+#define CPPPRJ_RENDER_H
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include "Snake.h"
+#include "Camera.h"
+#include "Atlas.h"
+
+/** \brief write textured quad of one cell into vertex array
+ *
+ * @param quad - pointer to four vertices of the quad
+ * @param x - column of the cell, also x position in cell units
+ * @param y - row of the cell, also y position in cell units
+ * @param tile - index of image in atlas_rects
+ */
+inline void set_cell_quad(sf::Vertex *quad, float x, float y, int tile) {
+    float left = float(atlas_rects[tile][0]);
+    float top = float(atlas_rects[tile][1]);
+    float right = left + float(atlas_rects[tile][2]);
+    float bottom = top + float(atlas_rects[tile][3]);
+    quad[0].position = sf::Vector2f(x, y);
+    quad[1].position = sf::Vector2f(x + 1, y);
+    quad[2].position = sf::Vector2f(x + 1, y + 1);
+    quad[3].position = sf::Vector2f(x, y + 1);
+    quad[0].texCoords = sf::Vector2f(left, top);
+    quad[1].texCoords = sf::Vector2f(right, top);
+    quad[2].texCoords = sf::Vector2f(right, bottom);
+    quad[3].texCoords = sf::Vector2f(left, bottom);
+}
+
+/** \brief draws part of the board seen by the camera.
+ *
+ * Geometry is built only for visible cells, in cell units, and drawn with one call
+ * from the atlas texture. So draw cost depends on the viewport, not on the board size.
+ */
+class Board_renderer {
+public:
+    /** \brief create renderer
+     *
+     * @param atlas - texture made from atlas_pixels
+     */
+    explicit Board_renderer(const sf::Texture &atlas) : atlas(&atlas), cells(sf::Quads) {}
+
+    /** \brief push visible cells to window
+     *
+     * Sets window view to the camera, caller should restore default view for screen space drawing.
+     *
+     * @param field - field to draw
+     * @param camera - camera over the field
+     * @param window - window or texture for pushing cells
+     */
+    void draw(const Field &field, const Camera &camera, sf::RenderTarget &window) {
+        Cell_range range = camera.visible();
+        cells.resize(std::size_t(range.count()) * 4);
+        std::size_t k = 0;
+        for (int i = range.first_x; i < range.last_x; i++) {
+            for (int j = range.first_y; j < range.last_y; j++) {
+                set_cell_quad(&cells[k], float(i), float(j), field.body[i][j]);
+                k += 4;
+            }
+        }
+        sf::View view;
+        view.setCenter(camera.center_x, camera.center_y);
+        view.setSize(camera.view_width(), camera.view_height());
+        window.setView(view);
+        window.draw(cells, sf::RenderStates(atlas));
+    }
+
+private:
+    ///atlas texture
+    const sf::Texture *atlas;
+    ///quads of visible cells
+    sf::VertexArray cells;
+};
+
+/** \brief downsampled overview of the whole board.
+ *
+ * Every pixel shows one sampled cell, the snake head and the camera view are marked on top.
+ */
+class Minimap {
+public:
+    ///size of the minimap in pixels
+    static constexpr unsigned size = 128;
+
+    /** \brief create minimap in the top right corner of the window
+     *
+     * @param window_width - window width in pixels
+     */
+    explicit Minimap(unsigned window_width) {
+        image.create(size, size, sf::Color::Black);
+        texture.create(size, size);
+        sprite.setTexture(texture);
+        sprite.setPosition(float(window_width - size - 8), 8.f);
+        frame.setFillColor(sf::Color(0, 0, 0, 0));
+        frame.setOutlineColor(sf::Color::Yellow);
+        frame.setOutlineThickness(1.f);
+    }
+
+    /** \brief resample field and push minimap to window
+     *
+     * Expects default view of the window.
+     *
+     * @param field - field to draw
+     * @param head - snake head
+     * @param camera - camera over the field
+     * @param window - window or texture for pushing minimap
+     */
+    void draw(const Field &field, const Vector &head, const Camera &camera, sf::RenderTarget &window) {
+        static const sf::Color colors[] = {sf::Color(40, 40, 40), sf::Color(128, 128, 128),
+                                           sf::Color(0, 200, 0), sf::Color(220, 0, 0)};
+        unsigned pixels = std::min(size, unsigned(field.size));
+        float scale = float(field.size) / float(pixels);
+        for (unsigned x = 0; x < pixels; x++)
+            for (unsigned y = 0; y < pixels; y++)
+                image.setPixel(x, y, colors[field.body[int(float(x) * scale)][int(float(y) * scale)]]);
+        image.setPixel(unsigned(float(head.x) / scale), unsigned(float(head.y) / scale), sf::Color::White);
+        texture.update(image);
+        sprite.setTextureRect(sf::IntRect(0, 0, int(pixels), int(pixels)));
+        sprite.setScale(float(size) / float(pixels), float(size) / float(pixels));
+        window.draw(sprite);
+
+        float to_map = float(size) / float(field.size);
+        sf::Vector2f corner = sprite.getPosition();
+        frame.setPosition((camera.center_x - camera.view_width() / 2) * to_map + corner.x,
+                          (camera.center_y - camera.view_height() / 2) * to_map + corner.y);
+        frame.setSize(sf::Vector2f(camera.view_width() * to_map, camera.view_height() * to_map));
+        window.draw(frame);
+    }
+
+private:
+    ///sampled cells
+    sf::Image image;
+    ///texture of sampled cells
+    sf::Texture texture;
+    ///sprite showing texture
+    sf::Sprite sprite;
+    ///rectangle of the camera view
+    sf::RectangleShape frame;
+};
+
+#endif //CPPPRJ_RENDER_H
@@ -1,9 +1,10 @@
 #ifndef CPPPRJ_SNAKE_H
 #define CPPPRJ_SNAKE_H
 
+#include <algorithm>
 #include <vector>
 #include <random>
-#include "windows.h"
+#include <ostream>
 
 
 ///id of empty place
@@ -14,6 +15,18 @@ constexpr int Wall_id = 1;
 constexpr int Snake_id = 2;
 ///id of apple
 constexpr int Apple_id = 3;
+///step() moved the snake to an empty cell or into the cell its tail leaves
+constexpr int Moved_event = 0;
+///step() moved the snake onto the apple and a new apple was placed
+constexpr int Ate_event = 1;
+///step() ate the last apple, the snake fills the field
+constexpr int Won_event = 2;
+///step() hit a wall, nothing changed
+constexpr int Wall_event = 3;
+///step() hit the snake's own body, nothing changed
+constexpr int Self_event = 4;
+///new_game() clears cell by cell while snake parts times this is less than the inner cells
+constexpr std::size_t Sparse_reset_ratio = 8;
 
 /** \brief The structure of the radius vector to the cell on the field.
  *
@@ -80,6 +93,27 @@ struct Vector {
     }
 };
 
+/** \brief direction code of a unit vector
+ *
+ * 0 - up, 1 - right, 2 - down, 3 - left.
+ *
+ * @param direction - unit vector
+ * @return 2-bit direction code
+ */
+inline int direction_code(const Vector &direction) {
+    return direction.y < 0 ? 0 : direction.x > 0 ? 1 : direction.y > 0 ? 2 : 3;
+}
+
+/** \brief unit vector of a direction code
+ *
+ * @param code - 2-bit direction code
+ * @return unit vector
+ */
+inline Vector direction_vector(int code) {
+    static const Vector directions[4] = {Vector(0, -1), Vector(1, 0), Vector(0, 1), Vector(-1, 0)};
+    return directions[code & 3];
+}
+
 /** \brief field object for the game
  *
  * square field object filled with cell states:
@@ -97,6 +131,8 @@ public:
     std::vector<std::vector<int>> body;
     ///random engine for generating apples
     std::default_random_engine engine;
+    ///cell of the last created apple
+    Vector apple;
 
     /**\brief generates field size*size.
      *
@@ -104,10 +140,18 @@ public:
      *
      * @param size - size of the field.
      */
-    explicit Field(int size = 10) {
+    explicit Field(int size = 10) : Field(size, std::random_device()()) {}
+
+    /**\brief generates field size*size with fixed random seed.
+     *
+     * Same seed gives same apples, so games can be reproduced.
+     *
+     * @param size - size of the field.
+     * @param seed - seed of random engine.
+     */
+    Field(int size, unsigned seed) {
         this->size = size;
-        std::random_device r;
-        this->engine = std::default_random_engine(r());
+        this->engine = std::default_random_engine(seed);
         for (int i = 0; i < size; i++) {
             std::vector<int> obj_column;
             for (int j = 0; j < size; j++) {
@@ -136,13 +180,104 @@ public:
             y = y_distribution(engine);
         }
         body[x][y] = Apple_id;
+        apple = Vector(x, y);
+    }
+
+    /** \brief makes every cell inside the walls empty
+     *
+     * Columns are filled as whole blocks.
+     */
+    void clear() {
+        for (int i = 1; i < size - 1; i++)
+            std::fill(body[i].begin() + 1, body[i].end() - 1, Empty_id);
+    }
+
+    /** \brief makes every cell inside the walls empty if only parts and apple are occupied
+     *
+     * Empties the given cells and the last apple, so the cost is proportional to the
+     * number of parts. Long snakes clear the whole field instead.
+     *
+     * @param parts - cells of the snake
+     */
+    void clear(const std::vector<Vector> &parts) {
+        if (parts.size() * Sparse_reset_ratio >= std::size_t(size - 2) * (size - 2)) {
+            clear();
+            return;
+        }
+        for (const Vector &part : parts)
+            body[part.x][part.y] = Empty_id;
+        if (body[apple.x][apple.y] == Apple_id)
+            body[apple.x][apple.y] = Empty_id;
+    }
+
+    /** \brief number of free cells connected to a cell
+     *
+     * Free cells are empty cells and apples, search goes cell by cell.
+     *
+     * @param start - first cell
+     * @return number of connected free cells, 0 if start isn't free
+     */
+    int reachable_area(const Vector &start) const {
+        auto is_free = [this](int x, int y) {
+            return body[x][y] == Empty_id or body[x][y] == Apple_id;
+        };
+        if (not is_free(start.x, start.y))
+            return 0;
+        std::vector<char> seen(std::size_t(size) * size, 0);
+        std::vector<Vector> stack{start};
+        seen[std::size_t(start.x) * size + start.y] = 1;
+        int total = 0;
+        while (not stack.empty()) {
+            Vector cell = stack.back();
+            stack.pop_back();
+            total++;
+            const Vector steps[4] = {Vector(0, -1), Vector(1, 0), Vector(0, 1), Vector(-1, 0)};
+            for (const Vector &step : steps) {
+                Vector next = cell + step;
+                char &mark = seen[std::size_t(next.x) * size + next.y];
+                if (mark == 0 and is_free(next.x, next.y)) {
+                    mark = 1;
+                    stack.push_back(next);
+                }
+            }
+        }
+        return total;
+    }
+};
+
+/** \brief outcome of one step of a game
+ */
+struct Step_result {
+    ///one of the *_event codes
+    unsigned char event = Moved_event;
+    ///an apple was eaten, also true when the game is won
+    bool ate = false;
+    ///number of snake parts after the step
+    int length = 0;
+    ///apple after the step, the eaten one under the head when the game is won
+    Vector apple;
+
+    /** \brief check if the game goes on, same as the result of move()
+     *
+     * @return true if the snake moved or ate and didn't win
+     */
+    bool working() const {
+        return event <= Ate_event;
     }
 };
 
 /** \brief Player snake object that contains field
  *
+ * Field_type is the storage of the field: it has size, body[x][y] cells, create_apple(),
+ * clear(parts) and a (size, seed) constructor. Snake is the game on the reference Field.
+ * Cells other than walls, snake parts and the last created apple must be empty when a new
+ * game starts, because clear(parts) may empty only these cells.
+ * Body grows with the snake and new_game() keeps its capacity, so a game that is warmed up
+ * doesn't allocate. reserve_body() gives that guarantee from the start at the cost of a
+ * body for every interior cell.
  */
-class Snake {
+template<class Field_type>
+class Basic_snake {
 public:
     ///Vector object that show snake head displacement after one move.
     Vector delta;
@@ -151,7 +286,7 @@ public:
     ///array of vectors that points out snake's parts.
     std::vector<Vector> body;
     ///field object.
-    Field field;
+    Field_type field;
 
     /** \brief create Snake object
      *
@@ -159,17 +294,23 @@ public:
      *
      * @param size - size of the field
      */
-    explicit Snake(int size) {
-        this->field = Field(size);
-        field.create_apple();
+    explicit Basic_snake(int size) : Basic_snake(size, std::random_device()()) {}
+
+    /** \brief create Snake object with fixed random seed
+     *
+     * @param size - size of the field
+     * @param seed - seed of field's random engine
+     */
+    Basic_snake(int size, unsigned seed) : field(size, seed) {
         this->delta = Vector(0, -1);
         this->last_delta = delta;
-        int x = size / 2;
-        int y = size / 2;
+        int x = field.size / 2;
+        int y = field.size / 2;
         this->body.emplace_back(x, y);
         this->body.emplace_back(x, y + 1);
         field.body[x][y] = Snake_id;
         field.body[x][y + 1] = Snake_id;
+        field.create_apple();
     }
 
     /** \brief restart game
@@ -177,14 +318,9 @@ public:
      * @return true if game is restarted successfully
      */
     bool new_game() {
-        for (int i = 1; i < field.size - 1; i++) {
-            for (int j = 1; j < field.size - 1; j++) {
-                field.body[i][j] = Empty_id;
-            }
-        }
+        field.clear(body);
         this->delta = Vector(0, -1);
         this->last_delta = delta;
-        field.create_apple();
         body.clear();
         int x = field.size / 2;
         int y = field.size / 2;
@@ -192,9 +328,18 @@ public:
         this->body.emplace_back(x, y + 1);
         field.body[x][y] = Snake_id;
         field.body[x][y + 1] = Snake_id;
+        field.create_apple();
         return true;
     }
 
+    /** \brief reserve body for every interior cell
+     *
+     * After it move(), create_apple() and new_game() never allocate.
+     */
+    void reserve_body() {
+        body.reserve(std::size_t(field.size - 2) * (field.size - 2));
+    }
+
     /** \brief change direction to up if it wasn't down
      */
     void up() {
@@ -241,39 +386,62 @@ public:
         field.body[temp.x][temp.y] = Snake_id;
     }
 
-    /** \brief default movement function.
+    /** \brief move and tell what happened.
      *
      * Check if there is an object on the way, react and move.
-     * Can manipulate field state and body length.
+     * The result is filled from the cell in front of the head, so callers don't have
+     * to look at the field again.
      *
-     * @return true if there wasn't obstacle, false otherwise
+     * @return event, eaten apple, length and apple after the step
      */
-    bool move() {
+    Step_result step() {
+        Step_result result;
         Vector next = body[0] + delta;
         switch (field.body[next.x][next.y]) {
             case Empty_id:
                 this->base_move();
-                return true;
+                result.event = Moved_event;
+                break;
             case Apple_id:
                 body.push_back(body[body.size() - 1]);
                 this->base_move();
+                result.ate = true;
                 if (body.size() < (field.size - 2) * (field.size - 2)) {
                     field.create_apple();
-                    return true;
+                    result.event = Ate_event;
                 } else
-                    return false;
+                    result.event = Won_event;
+                break;
             case Wall_id:
-                return false;
+                result.event = Wall_event;
+                break;
             case Snake_id:
                 if (next == body[body.size() - 1]) {
                     this->base_move();
-                    return true;
-                }
-                return false;
+                    result.event = Moved_event;
+                } else
+                    result.event = Self_event;
+                break;
             default:
                 std::terminate();
         }
+        result.length = int(body.size());
+        result.apple = field.apple;
+        return result;
+    }
+
+    /** \brief default movement function.
+     *
+     * Same as step(), without the details.
+     *
+     * @return true if there wasn't obstacle, false otherwise
+     */
+    bool move() {
+        return step().working();
     }
 };
 
+///snake game on the reference field
+using Snake = Basic_snake<Field>;
+
 #endif //CPPPRJ_SNAKE_H
@@ -0,0 +1,117 @@
+#ifndef CPPPRJ_STATS_H
+#define CPPPRJ_STATS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ostream>
+#include <vector>
+
+/** \brief accumulates latency samples.
+ *
+ * Keeps count, sum, minimum and maximum so that it never allocates.
+ */
+struct Latency_stats {
+    ///number of samples
+    long long count = 0;
+    ///sum of all samples in microseconds
+    long long total = 0;
+    ///smallest sample in microseconds
+    long long min = 0;
+    ///largest sample in microseconds
+    long long max = 0;
+
+    /** \brief add one sample
+     *
+     * @param latency - duration of the sample
+     */
+    void add(std::chrono::steady_clock::duration latency) {
+        long long us = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+        if (count == 0 or us < min)
+            min = us;
+        if (count == 0 or us > max)
+            max = us;
+        total += us;
+        count++;
+    }
+
+    /** \brief mean of the samples
+     *
+     * @return mean latency in microseconds, 0 if there are no samples
+     */
+    double mean() const {
+        return count == 0 ? 0. : double(total) / double(count);
+    }
+
+    /** \brief smart stream output called with <<
+     *
+     * outputs to stream object string with format:
+     * n = {count} mean = {mean} us min = {min} us max = {max} us
+     *
+     * @param out - stream object
+     * @param stats - object for output
+     * @return out stream object with stats outputed
+     */
+    friend std::ostream &operator<<(std::ostream &out, const Latency_stats &stats) {
+        out << "n = " << stats.count << " mean = " << stats.mean() << " us min = " << stats.min
+            << " us max = " << stats.max << " us";
+        return out;
+    }
+};
+
+/** \brief last samples of some value with percentiles.
+ *
+ * Storage is allocated once, new samples overwrite the oldest ones.
+ */
+class Rolling_window {
+public:
+    /** \brief create empty window
+     *
+     * @param capacity - number of kept samples
+     */
+    explicit Rolling_window(int capacity) : values(capacity), scratch(capacity) {}
+
+    /** \brief add sample, the oldest one is dropped when the window is full
+     *
+     * @param value - sample
+     */
+    void add(double value) {
+        values[next] = value;
+        next = (next + 1) % int(values.size());
+        count = std::min(count + 1, int(values.size()));
+    }
+
+    /** \brief number of kept samples
+     *
+     * @return number of samples
+     */
+    int size() const {
+        return count;
+    }
+
+    /** \brief percentile of kept samples
+     *
+     * @param p - percentile from 0 to 100
+     * @return nearest-rank percentile, 0 if there are no samples
+     */
+    double percentile(double p) {
+        if (count == 0)
+            return 0.;
+        std::copy(values.begin(), values.begin() + count, scratch.begin());
+        int rank = std::clamp(int(std::ceil(p / 100. * count)) - 1, 0, count - 1);
+        std::nth_element(scratch.begin(), scratch.begin() + rank, scratch.begin() + count);
+        return scratch[rank];
+    }
+
+private:
+    ///ring buffer of samples
+    std::vector<double> values;
+    ///copy of samples reordered by percentile()
+    std::vector<double> scratch;
+    ///index of the next sample
+    int next = 0;
+    ///number of kept samples
+    int count = 0;
+};
+
+#endif //CPPPRJ_STATS_H
@@ -0,0 +1,145 @@
+#ifndef CPPPRJ_TERMINAL_H
+#define CPPPRJ_TERMINAL_H
+
+#include <string>
+#include <vector>
+#include "Snake.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+/** \brief ANSI terminal renderer of Field that prints only changed cells.
+ *
+ * Every cell is two character columns colored by its id. The previously printed frame is kept,
+ * so a frame emits cursor moves and colors only for cells that changed, and the whole frame
+ * is written with one write() call. The frame buffer is reserved for the worst case when the
+ * size changes, so later frames don't allocate.
+ */
+class Terminal_renderer {
+public:
+    ///bytes of the last frame
+    std::size_t last_bytes = 0;
+    ///bytes of all frames
+    long long total_bytes = 0;
+    ///number of rendered frames
+    long long frames = 0;
+
+    /** \brief build escape sequences for the next frame
+     *
+     * First frame and frames after a size change clear the screen and print every cell.
+     *
+     * @param field - field to print
+     * @return escape sequences of the frame
+     */
+    const std::string &render(const Field &field) {
+        out.clear();
+        if (field.size != size) {
+            size = field.size;
+            shown.assign(std::size_t(size) * size, 0xff);
+            //every cell may need a cursor move, a color and two spaces
+            std::size_t cell_bytes = 4 + std::to_string(size).size() + std::to_string(2 * size).size() + 5 + 2;
+            out.reserve(std::size_t(size) * size * cell_bytes + 32);
+            out += "\x1b[?25l\x1b[2J";
+        }
+        int color = -1;
+        int row = -1, column = -1;
+        for (int j = 0; j < size; j++) {
+            for (int i = 0; i < size; i++) {
+                int id = field.body[i][j];
+                unsigned char &cell = shown[std::size_t(j) * size + i];
+                if (cell == id)
+                    continue;
+                cell = (unsigned char) id;
+                if (row != j or column != i) {
+                    out += "\x1b[";
+                    append_number(j + 1);
+                    out += ';';
+                    append_number(2 * i + 1);
+                    out += 'H';
+                }
+                if (color != id) {
+                    static const char *const colors[] = {"\x1b[40m", "\x1b[47m", "\x1b[42m", "\x1b[41m"};
+                    out += colors[id];
+                    color = id;
+                }
+                out += "  ";
+                row = j;
+                column = i + 1;
+            }
+        }
+        if (color != -1)
+            out += "\x1b[0m";
+        last_bytes = out.size();
+        total_bytes += (long long) out.size();
+        frames++;
+        return out;
+    }
+
+    /** \brief escape sequences that restore the terminal
+     *
+     * Move cursor below the board and show it.
+     *
+     * @return escape sequences
+     */
+    std::string finish() const {
+        return "\x1b[0m\x1b[" + std::to_string(size + 1) + ";1H\x1b[?25h";
+    }
+
+    /** \brief write the last rendered frame with one write() call
+     *
+     * @param fd - file descriptor of the terminal
+     * @return true if everything is written
+     */
+    bool flush(int fd = 1) const {
+        return write_all(fd, out);
+    }
+
+    /** \brief write whole string to file descriptor
+     *
+     * @param fd - file descriptor
+     * @param text - bytes to write
+     * @return true if everything is written
+     */
+    static bool write_all(int fd, const std::string &text) {
+        std::size_t done = 0;
+        while (done < text.size()) {
+#ifdef _WIN32
+            auto written = _write(fd, text.data() + done, unsigned(text.size() - done));
+#else
+            auto written = ::write(fd, text.data() + done, text.size() - done);
+#endif
+            if (written <= 0)
+                return false;
+            done += std::size_t(written);
+        }
+        return true;
+    }
+
+private:
+    ///size of the printed field
+    int size = 0;
+    ///cell ids of the printed frame, row by row
+    std::vector<unsigned char> shown;
+    ///escape sequences of the last frame
+    std::string out;
+
+    /** \brief append decimal number without temporary strings
+     *
+     * @param number - non-negative number
+     */
+    void append_number(int number) {
+        char digits[12];
+        int length = 0;
+        do {
+            digits[length++] = char('0' + number % 10);
+            number /= 10;
+        } while (number > 0);
+        while (length > 0)
+            out += digits[--length];
+    }
+};
+
+#endif //CPPPRJ_TERMINAL_H
@@ -0,0 +1,138 @@
+#ifndef CPPPRJ_USAGE_H
+#define CPPPRJ_USAGE_H
+
+#include <chrono>
+#include <ostream>
+
+#ifdef _WIN32
+#include "windows.h"
+#else
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#endif
+
+/** \brief CPU time consumed by the process
+ *
+ * Sums user and kernel time of all threads.
+ *
+ * @return CPU time in seconds
+ */
+inline double process_cpu_time() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (not GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+        return 0.;
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return double(k.QuadPart + u.QuadPart) * 1e-7;
+#else
+    timespec time{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+    return double(time.tv_sec) + double(time.tv_nsec) * 1e-9;
+#endif
+}
+
+/** \brief time since the process was launched
+ *
+ * Counts from process creation, so it includes loading of the executable and static initialization.
+ *
+ * @return wall time in seconds
+ */
+inline double process_uptime() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user, now;
+    if (not GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+        return 0.;
+    GetSystemTimeAsFileTime(&now);
+    ULARGE_INTEGER c, n;
+    c.LowPart = creation.dwLowDateTime;
+    c.HighPart = creation.dwHighDateTime;
+    n.LowPart = now.dwLowDateTime;
+    n.HighPart = now.dwHighDateTime;
+    return double(n.QuadPart - c.QuadPart) * 1e-7;
+#else
+    std::ifstream stat("/proc/self/stat");
+    std::ifstream uptime("/proc/uptime");
+    std::string line;
+    double since_boot = 0.;
+    if (not std::getline(stat, line) or not(uptime >> since_boot))
+        return 0.;
+    std::istringstream fields(line.substr(line.rfind(')') + 2));
+    std::string field;
+    for (int i = 3; i < 22; i++)
+        fields >> field;
+    unsigned long long start_ticks = 0;
+    fields >> start_ticks;
+    return since_boot - double(start_ticks) / double(sysconf(_SC_CLK_TCK));
+#endif
+}
+
+/** \brief measures share of one core used during some program state.
+ *
+ * Call start() when the state is entered and stop() when it is left,
+ * CPU and wall time are summed over all visits.
+ */
+struct Cpu_usage {
+    ///CPU time spent in the state in seconds
+    double cpu = 0.;
+    ///wall time spent in the state in seconds
+    double wall = 0.;
+
+    /** \brief enter measured state
+     */
+    void start() {
+        if (running)
+            return;
+        running = true;
+        cpu_start = process_cpu_time();
+        wall_start = std::chrono::steady_clock::now();
+    }
+
+    /** \brief leave measured state
+     */
+    void stop() {
+        if (not running)
+            return;
+        running = false;
+        cpu += process_cpu_time() - cpu_start;
+        wall += std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    }
+
+    /** \brief CPU usage in percents of one core
+     *
+     * @return CPU time divided by wall time, 0 if nothing was measured
+     */
+    double percent() const {
+        return wall > 0. ? 100. * cpu / wall : 0.;
+    }
+
+    /** \brief smart stream output called with <<
+     *
+     * outputs to stream object string with format:
+     * cpu {cpu} s / wall {wall} s = {percent} %
+     *
+     * @param out - stream object
+     * @param usage - object for output
+     * @return out stream object with usage outputed
+     */
+    friend std::ostream &operator<<(std::ostream &out, const Cpu_usage &usage) {
+        out << "cpu " << usage.cpu << " s / wall " << usage.wall << " s = " << usage.percent() << " %";
+        return out;
+    }
+
+private:
+    ///true between start() and stop()
+    bool running = false;
+    ///CPU time at start()
+    double cpu_start = 0.;
+    ///wall time at start()
+    std::chrono::steady_clock::time_point wall_start;
+};
+
+#endif //CPPPRJ_USAGE_H
@@ -0,0 +1,202 @@
+#ifndef CPPPRJ_WORKERS_H
+#define CPPPRJ_WORKERS_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** \brief persistent pool of worker threads.
+ *
+ * A job is a function of a range [begin, end), the range [0, count) is split into chunks
+ * that threads claim one by one. Threads are created once, so a job costs two wakeups
+ * instead of thread creation.
+ * A claim ticket keeps the job generation in the high 32 bits and the chunk in the low
+ * ones, and threads copy count and chunks of their generation under the mutex, so a
+ * thread late from a finished job can't run or take a chunk of the next one.
+ */
+class Workers {
+public:
+    /** \brief start worker threads
+     *
+     * @param threads - number of background threads, 0 runs every job on the calling thread
+     */
+    explicit Workers(int threads) {
+        for (int i = 0; i < threads; i++)
+            threads_.emplace_back([this] { work(); });
+    }
+
+    Workers(const Workers &) = delete;
+
+    Workers &operator=(const Workers &) = delete;
+
+    /** \brief stop worker threads
+     *
+     * Waits for the running job.
+     */
+    ~Workers() {
+        wait();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        wake.notify_all();
+        for (auto &thread : threads_)
+            thread.join();
+    }
+
+    /** \brief number of background threads
+     *
+     * @return number of background threads
+     */
+    int size() const {
+        return int(threads_.size());
+    }
+
+    /** \brief run job on the background threads and return immediately
+     *
+     * Without background threads the job runs before return.
+     * Previous job must be finished with wait().
+     *
+     * @param count - size of the range
+     * @param job - function of a subrange [begin, end)
+     */
+    void start(int count, std::function<void(int, int)> job) {
+        if (threads_.empty()) {
+            if (count > 0)
+                job(0, count);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            this->job = std::move(job);
+            this->count = count;
+            this->chunks = std::max(1, std::min(count, int(threads_.size())));
+            this->pending = chunks;
+            generation++;
+            this->next.store(ticket(generation, 0));
+        }
+        wake.notify_all();
+    }
+
+    /** \brief block until the job started by start() is finished
+     */
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return pending == 0; });
+    }
+
+    /** \brief run job on the background threads and the calling thread
+     *
+     * @param count - size of the range
+     * @param job - function of a subrange [begin, end)
+     */
+    void parallel_for(int count, std::function<void(int, int)> job) {
+        start(count, std::move(job));
+        if (not threads_.empty()) {
+            Job_size size;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                size = Job_size{generation, this->count, chunks};
+            }
+            run_chunks(size);
+            wait();
+        }
+    }
+
+private:
+    ///background threads
+    std::vector<std::thread> threads_;
+    ///guards job state
+    std::mutex mutex;
+    ///signals new job or stop
+    std::condition_variable wake;
+    ///signals finished job
+    std::condition_variable done;
+
+    /** \brief job state a thread copies under the mutex
+     */
+    struct Job_size {
+        ///generation of the job
+        unsigned long long generation;
+        ///size of the range
+        int count;
+        ///number of chunks
+        int chunks;
+    };
+
+    ///current job
+    std::function<void(int, int)> job;
+    ///size of the range of the current job
+    int count = 0;
+    ///number of chunks of the current job
+    int chunks = 0;
+    ///number of chunks not finished yet
+    int pending = 0;
+    ///next claim ticket, generation in the high bits and chunk in the low bits
+    std::atomic<unsigned long long> next{0};
+    ///number of started jobs
+    unsigned long long generation = 0;
+    ///true when threads must exit
+    bool stop = false;
+
+    /** \brief claim ticket of a chunk
+     *
+     * @param generation - generation of the job
+     * @param chunk - number of the chunk
+     * @return ticket
+     */
+    static unsigned long long ticket(unsigned long long generation, int chunk) {
+        return (generation & 0xffffffffull) << 32 | unsigned(chunk);
+    }
+
+    /** \brief claim and run chunks of one job until none are left
+     *
+     * A ticket is taken only if it has the generation of the job and a chunk left, so a
+     * late thread neither runs nor swallows chunks of a newer job. A taken chunk keeps the
+     * job unfinished, so job can't be replaced while it runs.
+     *
+     * @param size - job state copied under the mutex
+     */
+    void run_chunks(const Job_size &size) {
+        unsigned long long last = ticket(size.generation, size.chunks);
+        unsigned long long claim = next.load();
+        while (true) {
+            if (claim >> 32 != last >> 32 or claim >= last)
+                return;
+            if (not next.compare_exchange_weak(claim, claim + 1))
+                continue;
+            long long chunk = (long long) (claim & 0xffffffffull), total = size.count, parts = size.chunks;
+            job(int(chunk * total / parts), int((chunk + 1) * total / parts));
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--pending == 0)
+                    done.notify_all();
+            }
+            claim = next.load();
+        }
+    }
+
+    /** \brief loop of background thread
+     */
+    void work() {
+        unsigned long long seen = 0;
+        while (true) {
+            Job_size size;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stop or generation != seen; });
+                if (stop)
+                    return;
+                seen = generation;
+                size = Job_size{generation, count, chunks};
+            }
+            run_chunks(size);
+        }
+    }
+};
+
+#endif //CPPPRJ_WORKERS_H
@@ -0,0 +1,85 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "Bench_compare.h"
+
+/** \brief read whole file
+ *
+ * @param path - path of the file
+ * @param text - content of the file
+ * @return true if the file is read
+ */
+bool read_file(const std::string &path, std::string &text) {
+    std::FILE *in = std::fopen(path.c_str(), "rb");
+    if (in == nullptr)
+        return false;
+    char buffer[4096];
+    std::size_t count;
+    while ((count = std::fread(buffer, 1, sizeof(buffer), in)) > 0)
+        text.append(buffer, count);
+    bool read = std::ferror(in) == 0;
+    std::fclose(in);
+    return read;
+}
+
+/** \brief read benchmarks of a snake_bench JSON file
+ *
+ * @param path - path of the file
+ * @param benchmarks - read benchmarks
+ * @return true if the file is read and valid
+ */
+bool read_benchmarks(const std::string &path, std::vector<Bench_samples> &benchmarks) {
+    std::string text;
+    if (not read_file(path, text)) {
+        std::fprintf(stderr, "bench_compare: can't read %s\n", path.c_str());
+        return false;
+    }
+    if (not Bench_json_reader(text).read(benchmarks)) {
+        std::fprintf(stderr, "bench_compare: %s isn't snake_bench JSON\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+/** \brief compare a snake_bench run with the stored baseline.
+ *
+ * Usage: bench_compare BASELINE CURRENT [--threshold T]
+ * Every benchmark of the baseline is tracked. Medians of the repetitions are compared and
+ * a benchmark regresses when the whole 95% confidence interval of the slowdown is above
+ * the threshold, 0.1 (10%) by default. A table of all tracked benchmarks is printed.
+ *
+ * @param argc - number of command line arguments
+ * @param argv - command line arguments
+ * @return 0 if nothing regressed, 1 if some benchmark regressed or is missing, 2 on bad input
+ */
+int main(int argc, char *argv[]) {
+    std::vector<std::string> paths;
+    double threshold = 0.1;
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        if (option == "--threshold" and i + 1 < argc)
+            threshold = std::atof(argv[++i]);
+        else
+            paths.push_back(option);
+    }
+    if (paths.size() != 2) {
+        std::fprintf(stderr, "usage: bench_compare BASELINE CURRENT [--threshold T]\n");
+        return 2;
+    }
+    std::vector<Bench_samples> baseline, current;
+    if (not read_benchmarks(paths[0], baseline) or not read_benchmarks(paths[1], current))
+        return 2;
+
+    std::vector<Bench_change> changes = compare_runs(baseline, current, threshold);
+    print_changes(stdout, changes);
+    int regressed = 0, missing = 0, improved = 0;
+    for (const Bench_change &change : changes) {
+        regressed += change.regressed;
+        missing += change.missing;
+        improved += change.improved;
+    }
+    std::printf("%zu tracked, %d regressed, %d missing, %d improved, threshold %.1f%%\n", changes.size(), regressed,
+                missing, improved, threshold * 100);
+    return regressed == 0 and missing == 0 ? 0 : 1;
+}
@@ -0,0 +1,405 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include "Snake.h"
+#include "Bit_field.h"
+#include "Fixed_field.h"
+#include "Bot.h"
+#include "Linked_snake.h"
+#include "Batch.h"
+#include "Arena.h"
+#include "Bench.h"
+
+#ifdef SNAKE_BENCH_DRAW
+#include "Render.h"
+#endif
+
+/** \brief fill random interior cells of a field with snake parts
+ *
+ * The central cell is kept empty, so an apple can always be placed.
+ *
+ * @param field - field with body[x][y] cells
+ * @param percent - share of filled interior cells
+ * @param seed - seed of the pattern
+ */
+template<class Field_type>
+void fill_field(Field_type &field, int percent, unsigned seed) {
+    std::default_random_engine engine(seed);
+    std::uniform_int_distribution<int> distribution(0, 99);
+    for (int x = 1; x < field.size - 1; x++)
+        for (int y = 1; y < field.size - 1; y++)
+            if (distribution(engine) < percent)
+                field.body[x][y] = Snake_id;
+    field.body[field.size / 2][field.size / 2] = Empty_id;
+}
+
+/** \brief random empty cell of the reference field
+ *
+ * Same rejection sampling as Field::create_apple(), without placing the apple.
+ *
+ * @param field - reference field
+ * @return empty cell
+ */
+Vector grid_empty_cell(Field &field) {
+    std::uniform_int_distribution<int> x_distribution(1, field.size - 2);
+    std::uniform_int_distribution<int> y_distribution(1, field.size - 2);
+    int x = x_distribution(field.engine);
+    int y = y_distribution(field.engine);
+    while (field.body[x][y] != Empty_id) {
+        x = x_distribution(field.engine);
+        y = y_distribution(field.engine);
+    }
+    return Vector(x, y);
+}
+
+/** \brief time game steps driven by the bot
+ *
+ * One step is a bot turn and a move, the game restarts when it ends.
+ *
+ * @tparam Game - Snake or other Basic_snake
+ * @param name - name of the benchmark
+ * @param game - game to play
+ * @param min_seconds - shortest timed run
+ * @return timing of one step
+ */
+template<class Game>
+Bench_result bench_steps(const std::string &name, Game &game, double min_seconds) {
+    std::default_random_engine bot_engine(11);
+    return run_bench(name, [&] {
+        bot_turn(game, bot_engine);
+        if (not game.move())
+            game.new_game();
+        return game.body.size();
+    }, min_seconds);
+}
+
+/** \brief time game moves with turns from a prepared list
+ *
+ * Turns are drawn before timing, so only the engine is timed. The game restarts when it ends.
+ *
+ * @tparam Game - any engine with up(), right(), down(), left(), move() and new_game()
+ * @param name - name of the benchmark
+ * @param game - game to play
+ * @param min_seconds - shortest timed run
+ * @return timing of one move
+ */
+template<class Game>
+Bench_result bench_moves(const std::string &name, Game &game, double min_seconds) {
+    std::vector<unsigned char> turns(4096);
+    std::default_random_engine engine(13);
+    std::uniform_int_distribution<int> turn(0, 15);
+    for (unsigned char &t : turns)
+        t = (unsigned char) turn(engine);
+    std::size_t k = 0;
+    return run_bench(name, [&] {
+        switch (turns[k++ % turns.size()]) {
+            case 0: game.up(); break;
+            case 1: game.right(); break;
+            case 2: game.down(); break;
+            case 3: game.left(); break;
+            default: break;
+        }
+        bool working = game.move();
+        if (not working)
+            game.new_game();
+        return working;
+    }, min_seconds);
+}
+
+/** \brief entry points of the reference engine
+ *
+ * @param report - report for results
+ * @param size - size of the field
+ * @param min_seconds - shortest timed run
+ */
+void bench_snake(Bench_report &report, int size, double min_seconds) {
+    std::string suffix = "/" + std::to_string(size);
+    double cells = double(size) * size;
+
+    Snake moved(size, 1);
+    report.add(bench_moves("snake/move" + suffix, moved, min_seconds));
+
+    //head goes around a square of four cells, so it never leaves the field
+    Snake circling(size, 1);
+    const Vector square[4] = {Vector(0, -1), Vector(1, 0), Vector(0, 1), Vector(-1, 0)};
+    int turn = 0;
+    report.add(run_bench("snake/base_move" + suffix, [&] {
+        circling.delta = square[turn++ & 3];
+        circling.base_move();
+        return circling.body[0].x;
+    }, min_seconds));
+
+    Snake stepped(size, 1);
+    report.add(bench_steps("snake/step" + suffix, stepped, min_seconds));
+
+    Snake restarted(size, 1);
+    report.add(run_bench("snake/new_game" + suffix, [&] {
+        return restarted.new_game();
+    }, min_seconds));
+    report.add(run_bench("snake/clear" + suffix, [&] {
+        restarted.field.clear();
+        return restarted.field.size;
+    }, min_seconds, cells));
+
+    report.add(run_bench("field/construct" + suffix, [&] {
+        Field field(size, 1);
+        return field.size;
+    }, min_seconds, cells));
+
+    Snake original(size, 1);
+    report.add(run_bench("snake/copy" + suffix, [&] {
+        Snake copy(original);
+        return copy.field.size;
+    }, min_seconds, cells));
+
+    for (int percent : {0, 50, 90, 99}) {
+        Field field(size, 1);
+        fill_field(field, percent, 7);
+        report.add(run_bench("field/create_apple" + suffix + "/fill" + std::to_string(percent), [&] {
+            field.create_apple();
+            field.body[field.apple.x][field.apple.y] = Empty_id;
+            return field.apple.x;
+        }, min_seconds));
+    }
+}
+
+/** \brief Fixed_snake on the sizes with a specialization
+ *
+ * @param report - report for results
+ * @param size - size of the field
+ * @param min_seconds - shortest timed run
+ */
+void bench_fixed(Bench_report &report, int size, double min_seconds) {
+    std::string suffix = "/" + std::to_string(size);
+    with_snake(size, 1, [&](auto &game) {
+        report.add(bench_steps("fixed/step" + suffix, game, min_seconds));
+        report.add(run_bench("fixed/new_game" + suffix, [&] {
+            return game.new_game();
+        }, min_seconds));
+        return 0;
+    });
+}
+
+/** \brief Linked_snake on the linear board
+ *
+ * @param report - report for results
+ * @param size - size of the field
+ * @param min_seconds - shortest timed run
+ */
+void bench_linked(Bench_report &report, int size, double min_seconds) {
+    std::string suffix = "/" + std::to_string(size);
+    Linked_snake moved(size, 1);
+    report.add(bench_moves("linked/move" + suffix, moved, min_seconds));
+    Linked_snake restarted(size, 1);
+    report.add(run_bench("linked/new_game" + suffix, [&] {
+        return restarted.new_game();
+    }, min_seconds));
+    report.add(run_bench("linked/clear" + suffix, [&] {
+        restarted.board.clear();
+        return restarted.board.size;
+    }, min_seconds, double(size) * size));
+}
+
+/** \brief flood fill and random empty cell of Bit_field against Field
+ *
+ * @param report - report for results
+ * @param size - size of the field
+ * @param min_seconds - shortest timed run
+ */
+void bench_bits(Bench_report &report, int size, double min_seconds) {
+    for (int percent : {0, 50, 90, 99}) {
+        Field grid(size, 1);
+        Bit_field bits(size, 1);
+        fill_field(grid, percent, 7);
+        fill_field(bits, percent, 7);
+        Vector start(size / 2, size / 2);
+        std::string suffix = "/" + std::to_string(size) + "/fill" + std::to_string(percent);
+        report.add(run_bench("field/flood_fill" + suffix, [&] {
+            return grid.reachable_area(start);
+        }, min_seconds));
+        report.add(run_bench("bits/flood_fill" + suffix, [&] {
+            return bits.reachable_area(start);
+        }, min_seconds));
+        report.add(run_bench("field/empty_cell" + suffix, [&] {
+            return grid_empty_cell(grid).x;
+        }, min_seconds));
+        report.add(run_bench("bits/empty_cell" + suffix, [&] {
+            return bits.random_empty_cell().x;
+        }, min_seconds));
+    }
+}
+
+/** \brief batched games: step with masks, mask recomputation, mask reads and
+ * auto reset steps on 4 worker threads
+ *
+ * items/s counts games.
+ *
+ * @param report - report for results
+ * @param count - number of games
+ * @param size - size of every field
+ * @param min_seconds - shortest timed run
+ */
+void bench_batch(Bench_report &report, int count, int size, double min_seconds) {
+    std::string suffix = "/" + std::to_string(count) + "x" + std::to_string(size);
+    Batch<Snake> batch(count, size, 1);
+    std::vector<unsigned char> actions(batch.size());
+    std::default_random_engine engine(17);
+    std::uniform_int_distribution<int> action(0, 15);
+    for (unsigned char &a : actions)
+        a = (unsigned char) action(engine);
+    std::vector<Step_result> results(batch.size());
+    report.add(run_bench("batch/step" + suffix, [&] {
+        batch.step(actions.data(), results.data());
+        for (std::size_t k = 0; k < batch.size(); k++)
+            if (not results[k].working())
+                batch.games[k].new_game();
+        return results[0].length;
+    }, min_seconds, double(count)));
+    report.add(run_bench("batch/update_masks" + suffix, [&] {
+        batch.update_masks();
+        return batch.safe_actions()[0];
+    }, min_seconds, double(count)));
+    std::vector<unsigned char> masks(batch.size());
+    report.add(run_bench("batch/safe_actions" + suffix, [&] {
+        std::copy(batch.safe_actions(), batch.safe_actions() + batch.size(), masks.begin());
+        return masks[0];
+    }, min_seconds, double(count)));
+    Batch<Snake> threaded(count, size, 1, true, 4);
+    report.add(run_bench("batch/step_async" + suffix, [&] {
+        threaded.step_async(actions.data());
+        return threaded.wait()[0].length;
+    }, min_seconds, double(count)));
+}
+
+/** \brief ticks of an arena with simultaneous moves
+ *
+ * Snakes turn at random about once in 8 ticks from a precomputed table, so the time is
+ * the resolution, and the arena restarts when fewer than 2 snakes are left.
+ * items/s counts ticks.
+ *
+ * @param report - report for results
+ * @param count - number of snakes
+ * @param size - size of the field
+ * @param min_seconds - shortest timed run
+ */
+void bench_arena(Bench_report &report, int count, int size, double min_seconds) {
+    Arena arena(size, count, 1, count);
+    std::vector<unsigned char> actions(std::size_t(4096) * count);
+    std::default_random_engine engine(23);
+    std::uniform_int_distribution<int> action(0, 31);
+    for (unsigned char &a : actions)
+        a = (unsigned char) action(engine);
+    std::size_t next = 0;
+    report.add(run_bench("arena/step/" + std::to_string(count) + "x" + std::to_string(size), [&] {
+        for (Arena_snake &snake : arena.snakes)
+            apply_action(snake, actions[next++]);
+        if (next == actions.size())
+            next = 0;
+        const Step_result *results = arena.step();
+        if (arena.alive() < 2)
+            arena.new_game();
+        return results[0].length;
+    }, min_seconds));
+}
+
+#ifdef SNAKE_BENCH_DRAW
+
+/** \brief draw path of the game window into an offscreen texture
+ *
+ * Same calls as draw() of the game: visible cells, then the minimap when the board
+ * doesn't fit. items/s counts visible cells.
+ *
+ * @param report - report for results
+ * @param target - offscreen texture of window size
+ * @param atlas - texture made from atlas_pixels
+ * @param size - size of the field
+ * @param min_seconds - shortest timed run
+ */
+void bench_draw(Bench_report &report, sf::RenderTexture &target, const sf::Texture &atlas, int size,
+                double min_seconds) {
+    sf::Vector2u side = target.getSize();
+    Snake snake(size, 1);
+    Camera camera(size, float(side.x), float(side.y));
+    camera.follow(snake.body[0]);
+    Board_renderer board(atlas);
+    Minimap minimap(side.x);
+    report.add(run_bench("draw/frame/" + std::to_string(size), [&] {
+        target.clear();
+        board.draw(snake.field, camera, target);
+        target.setView(target.getDefaultView());
+        if (camera.view_width() < float(size) or camera.view_height() < float(size))
+            minimap.draw(snake.field, snake.body[0], camera, target);
+        target.display();
+        return size;
+    }, min_seconds, double(camera.visible().count())));
+}
+
+#endif
+
+/** \brief micro benchmarks of the snake engines.
+ *
+ * Covers move, base_move, bot steps, new_game, clear, construction and copy of the
+ * reference engine, create_apple at several fill levels, the other engines and,
+ * if built with SNAKE_BENCH_DRAW, the draw path of the game window.
+ * Names are engine/operation/size, items/s counts cells for construction, copy and clear.
+ * On Linux IPC and cache and branch misses per operation are added when perf_event_open is allowed.
+ * Command line options:
+ * --time S - shortest timed run in seconds, 0.1 by default.
+ * --repetitions N - timed runs of every benchmark, the median is reported, 1 by default.
+ * --filter A,B - run only benchmarks with A or B in the name.
+ * --json PATH - also write results as JSON.
+ *
+ * @param argc - number of command line arguments
+ * @param argv - command line arguments
+ * @return 0 if results are written, 1 otherwise
+ */
+int main(int argc, char *argv[]) {
+    double min_seconds = 0.1;
+    std::string json;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string option = argv[i];
+        if (option == "--time")
+            min_seconds = std::atof(argv[i + 1]);
+        else if (option == "--repetitions")
+            bench_repetitions = std::max(1, std::atoi(argv[i + 1]));
+        else if (option == "--filter")
+            bench_filter = argv[i + 1];
+        else if (option == "--json")
+            json = argv[i + 1];
+    }
+    if (not bench_counters().available())
+        std::fprintf(stderr, "snake_bench: hardware counters unavailable, timing only\n");
+    Bench_report report;
+    for (int size : {6, 8, 10, 16, 32, 64, 256, 1024})
+        bench_snake(report, size, min_seconds);
+    for (int size : {8, 10, 16, 32, 64})
+        bench_fixed(report, size, min_seconds);
+    for (int size : {6, 16, 64, 256, 1024})
+        bench_linked(report, size, min_seconds);
+    for (int size : {16, 32, 64})
+        bench_bits(report, size, min_seconds);
+    bench_batch(report, 10000, 16, min_seconds);
+    bench_arena(report, 16, 256, min_seconds);
+#ifdef SNAKE_BENCH_DRAW
+    sf::RenderTexture target;
+    sf::Texture atlas;
+    if (target.create(640, 640) and atlas.create(atlas_width, atlas_height)) {
+        atlas.update(atlas_pixels);
+        for (int size : {6, 16, 64, 256, 1024})
+            bench_draw(report, target, atlas, size, min_seconds);
+    } else
+        std::fprintf(stderr, "snake_bench: no render texture, draw benchmarks skipped\n");
+#endif
+    if (json.empty())
+        return 0;
+    std::FILE *out = std::fopen(json.c_str(), "w");
+    bool written = out != nullptr and report.write_json(out);
+    if (out != nullptr)
+        written = std::fclose(out) == 0 and written;
+    if (not written)
+        std::fprintf(stderr, "snake_bench: can't write %s\n", json.c_str());
+    return written ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Snake.h"
+#include "Bot.h"
+#include "Raster.h"
+#include "Checksum.h"
+#include "Atlas_data.h"
+
+/** \brief headless frame capture of bot games.
+ *
+ * Renders games with the CPU rasterizer, no display is needed.
+ * Command line options:
+ * --size N - size of the field, 64 by default.
+ * --cell N - cell size in pixels, 8 by default.
+ * --frames N - number of frames, 1000 by default.
+ * --format ppm|y4m - stream format, ppm by default.
+ * --out PATH - output file, - for stdout (default).
+ * --seed N - seed of the game and the bot.
+ * --threads N - background render threads, 0 by default.
+ * --checksums PATH - also write the state checksum of every tick, for checksum_compare.
+ * Render and total frame rates are printed to stderr.
+ *
+ * @param argc - number of command line arguments
+ * @param argv - command line arguments
+ * @return 0 if all frames are written, 1 otherwise
+ */
+int main(int argc, char *argv[]) {
+    int size = 64, cell = 8, frames = 1000, threads = 0;
+    unsigned seed = std::random_device()();
+    std::string format = "ppm", path = "-", checksums;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string option = argv[i];
+        if (option == "--size")
+            size = std::max(6, std::atoi(argv[i + 1]));
+        else if (option == "--cell")
+            cell = std::max(1, std::atoi(argv[i + 1]));
+        else if (option == "--frames")
+            frames = std::atoi(argv[i + 1]);
+        else if (option == "--format")
+            format = argv[i + 1];
+        else if (option == "--out")
+            path = argv[i + 1];
+        else if (option == "--seed")
+            seed = unsigned(std::strtoul(argv[i + 1], nullptr, 10));
+        else if (option == "--threads")
+            threads = std::max(0, std::atoi(argv[i + 1]));
+        else if (option == "--checksums")
+            checksums = argv[i + 1];
+    }
+    std::FILE *out = path == "-" ? stdout : std::fopen(path.c_str(), "wb");
+    if (out == nullptr) {
+        std::fprintf(stderr, "snake_capture: can't open %s\n", path.c_str());
+        return 1;
+    }
+    std::FILE *checksum_out = nullptr;
+    if (not checksums.empty() and (checksum_out = std::fopen(checksums.c_str(), "w")) == nullptr) {
+        std::fprintf(stderr, "snake_capture: can't open %s\n", checksums.c_str());
+        return 1;
+    }
+
+    Snake snake(size, seed);
+    std::default_random_engine bot_engine(seed);
+    State_checksum checksum(snake);
+    Tile_set tiles(atlas_pixels, atlas_width, atlas_rects, cell);
+    Rasterizer rasterizer(tiles, threads);
+    int side = rasterizer.frame_size(snake.field);
+    std::vector<unsigned char> frame(std::size_t(side) * side * 3);
+    std::unique_ptr<Y4m_writer> y4m;
+    if (format == "y4m")
+        y4m = std::make_unique<Y4m_writer>(out, side, side);
+
+    bool written = checksum_out == nullptr or (write_checksum_header(checksum_out, size, seed) and
+                                               write_checksum(checksum_out, 0, checksum.value(snake)));
+    std::chrono::steady_clock::duration render_time{};
+    auto begin = std::chrono::steady_clock::now();
+    for (int k = 0; k < frames and written; k++) {
+        play_bot_tick(snake, bot_engine, checksum);
+        if (checksum_out != nullptr)
+            written = write_checksum(checksum_out, k + 1, checksum.value(snake));
+        auto render_begin = std::chrono::steady_clock::now();
+        rasterizer.render(snake.field, frame.data());
+        render_time += std::chrono::steady_clock::now() - render_begin;
+        written = written and (y4m != nullptr ? y4m->write(frame.data()) : write_ppm(out, side, side, frame.data()));
+    }
+    double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    double render = std::chrono::duration<double>(render_time).count();
+    y4m.reset();
+    if (out != stdout)
+        std::fclose(out);
+    if (checksum_out != nullptr)
+        written = std::fclose(checksum_out) == 0 and written;
+    std::fprintf(stderr, "snake_capture: %d frames %dx%d, render %.0f frames/sec, total %.0f frames/sec\n",
+                 frames, side, side, frames / render, frames / total);
+    return written ? 0 : 1;
+}
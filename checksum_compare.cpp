@@ -0,0 +1,88 @@
+#include <cstdio>
+#include <random>
+#include <string>
+#include "Snake.h"
+#include "Checksum.h"
+
+/** \brief read checksum stream file
+ *
+ * @param path - path of the file
+ * @param stream - read stream
+ * @return true if the file is read and valid
+ */
+bool read_stream(const std::string &path, Checksum_stream &stream) {
+    std::FILE *in = std::fopen(path.c_str(), "r");
+    if (in == nullptr) {
+        std::fprintf(stderr, "checksum_compare: can't read %s\n", path.c_str());
+        return false;
+    }
+    bool read = read_checksums(in, stream);
+    std::fclose(in);
+    if (not read)
+        std::fprintf(stderr, "checksum_compare: %s isn't a checksum stream\n", path.c_str());
+    return read;
+}
+
+/** \brief print checksum of a stream at tick
+ *
+ * @param name - name of the stream
+ * @param stream - stream
+ * @param tick - tick
+ */
+void print_checksum(const char *name, const Checksum_stream &stream, long long tick) {
+    if (tick < (long long) stream.values.size())
+        std::printf("%s: %016llx\n", name, (unsigned long long) stream.values[tick]);
+    else
+        std::printf("%s: ended after %zu ticks\n", name, stream.values.size());
+}
+
+/** \brief compare two checksum streams of the same bot game.
+ *
+ * Usage: checksum_compare FIRST SECOND
+ * Streams are written by snake_capture --checksums. On a difference the first divergent tick
+ * is printed with both checksums, then the game is replayed from size and seed of the first
+ * stream and the local state before and at that tick is dumped, with the stream it matches.
+ *
+ * @param argc - number of command line arguments
+ * @param argv - command line arguments
+ * @return 0 if the streams are equal, 1 if they diverge, 2 on bad input
+ */
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        std::fprintf(stderr, "usage: checksum_compare FIRST SECOND\n");
+        return 2;
+    }
+    Checksum_stream first, second;
+    if (not read_stream(argv[1], first) or not read_stream(argv[2], second))
+        return 2;
+    if (first.size != second.size or first.seed != second.seed)
+        std::printf("different games: size %d seed %u and size %d seed %u\n", first.size, first.seed,
+                    second.size, second.seed);
+    long long tick = first_divergence(first, second);
+    if (tick < 0) {
+        std::printf("%zu ticks, streams are equal\n", first.values.size());
+        return 0;
+    }
+    std::printf("first divergence at tick %lld\n", tick);
+    print_checksum("first", first, tick);
+    print_checksum("second", second, tick);
+
+    Snake snake(first.size, first.seed);
+    std::default_random_engine bot_engine(first.seed);
+    State_checksum checksum(snake);
+    for (long long k = 0; k < tick; k++) {
+        if (k + 1 == tick) {
+            std::printf("\nlocal replay at tick %lld:\n", k);
+            dump_state(stdout, snake);
+        }
+        play_bot_tick(snake, bot_engine, checksum);
+    }
+    std::uint64_t local = checksum.value(snake);
+    const char *matches = tick < (long long) first.values.size() and local == first.values[tick] ? "first" :
+                          tick < (long long) second.values.size() and local == second.values[tick] ? "second" :
+                          "neither";
+    std::printf("\nlocal replay at tick %lld, checksum %016llx matches %s:\n", tick, (unsigned long long) local,
+                matches);
+    dump_state(stdout, snake);
+    return 1;
+}
@@ -0,0 +1,297 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include "Snake.h"
+#include "Packed_field.h"
+#include "Bit_field.h"
+#include "Fixed_field.h"
+#include "Linked_snake.h"
+#include "Bot.h"
+
+/** \brief report a divergence from the reference engine and abort
+ *
+ * Abort is what libFuzzer catches to save the crashing input.
+ *
+ * @param engine - name of the diverged engine
+ * @param what - diverged part of the state
+ * @param tick - number of the move, 0 is the state after construction
+ * @param size - size of the field
+ * @param seed - seed of the games
+ */
+[[noreturn]] void diverged(const char *engine, const char *what, int tick, int size, unsigned seed) {
+    std::fprintf(stderr, "snake_fuzz: %s differs from Snake in %s at tick %d, size %d, seed %u\n", engine, what,
+                 tick, size, seed);
+    std::abort();
+}
+
+/** \brief compare results of step()
+ *
+ * @param expected - result of the reference
+ * @param result - result of another engine
+ * @return true if event, eaten apple, length and apple are equal
+ */
+bool same_step(const Step_result &expected, const Step_result &result) {
+    return result.event == expected.event and result.ate == expected.ate and result.length == expected.length and
+           result.apple == expected.apple;
+}
+
+///ticks between comparisons of every cell, other ticks compare only the cells a move can change
+constexpr int Full_check_period = 64;
+
+/** \brief cells to compare after a tick
+ */
+struct Checked_cells {
+    ///compare every cell
+    bool all = true;
+    ///cells a move can change: old tail, new head and apple
+    Vector cells[3];
+};
+
+/** \brief id of a cell of a Basic_snake
+ *
+ * @tparam Game - Basic_snake on any field type
+ * @param game - game
+ * @param cell - cell of the field
+ * @return cell id
+ */
+template<class Game>
+int cell_id(const Game &game, const Vector &cell) {
+    return game.field.body[cell.x][cell.y];
+}
+
+/** \brief id of a cell of Linked_snake
+ *
+ * @param linked - game
+ * @param cell - cell of the field
+ * @return cell id
+ */
+int cell_id(const Linked_snake &linked, const Vector &cell) {
+    return linked.cell(cell.x, cell.y);
+}
+
+/** \brief compare cells with the reference
+ *
+ * @tparam Game - any engine with cell_id()
+ * @param reference - reference game
+ * @param game - compared game
+ * @param checked - cells to compare
+ * @return true if the cells are equal
+ */
+template<class Game>
+bool same_cells(const Snake &reference, const Game &game, const Checked_cells &checked) {
+    if (not checked.all) {
+        for (const Vector &cell : checked.cells)
+            if (cell_id(game, cell) != reference.field.body[cell.x][cell.y])
+                return false;
+        return true;
+    }
+    for (int i = 0; i < reference.field.size; i++)
+        for (int j = 0; j < reference.field.size; j++)
+            if (cell_id(game, Vector(i, j)) != reference.field.body[i][j])
+                return false;
+    return true;
+}
+
+/** \brief find the first difference of a Basic_snake from the reference
+ *
+ * @tparam Game - Basic_snake on any field type
+ * @param reference - reference game
+ * @param game - compared game
+ * @param checked - cells to compare
+ * @return name of the diverged part of the state, nullptr if the states are equal
+ */
+template<class Game>
+const char *difference(const Snake &reference, const Game &game, const Checked_cells &checked) {
+    if (game.delta != reference.delta or game.last_delta != reference.last_delta)
+        return "direction";
+    if (game.body != reference.body)
+        return "body";
+    if (game.field.apple != reference.field.apple)
+        return "apple";
+    return same_cells(reference, game, checked) ? nullptr : "cells";
+}
+
+/** \brief find the first difference of Linked_snake from the reference
+ *
+ * Walks the links from the tail instead of building body(), so nothing is allocated.
+ *
+ * @param reference - reference game
+ * @param linked - compared game
+ * @param checked - cells to compare
+ * @return name of the diverged part of the state, nullptr if the states are equal
+ */
+const char *difference(const Snake &reference, const Linked_snake &linked, const Checked_cells &checked) {
+    const Linear_board &board = linked.board;
+    if (linked.delta != reference.delta or linked.last_delta != reference.last_delta)
+        return "direction";
+    if (std::size_t(board.length) != reference.body.size())
+        return "length";
+    int part = board.tail;
+    for (int k = board.length - 1; k >= 0; k--) {
+        if (board.position(part) != reference.body[k])
+            return "body";
+        part += board.offsets[board.cells[part] >> 2];
+    }
+    if (board.position(linked.apple) != reference.field.apple)
+        return "apple";
+    return same_cells(reference, linked, checked) ? nullptr : "cells";
+}
+
+/** \brief play one input on every engine in lockstep with the reference Snake
+ *
+ * Input bytes: 4 bytes of seed, 1 byte of size, then one byte per tick whose low 3 bits
+ * are a turn code. Sizes 4-16 are the most common, so games often fill the board.
+ * Every tick the result of step(), directions, body, apple and the cells the move could
+ * change are compared. Every cell is compared after construction, after every restart and
+ * every Full_check_period ticks, so a stray write is found within that many ticks.
+ * Games that end are restarted with new_game() on every engine.
+ * Engines are Packed_snake, Bit_snake, Linked_snake and the game given by with_snake(),
+ * which is a Fixed_snake for sizes with a specialization.
+ *
+ * @param data - input bytes
+ * @param length - number of input bytes
+ * @return number of played ticks
+ */
+long long play_input(const std::uint8_t *data, std::size_t length) {
+    if (length < 5)
+        return 0;
+    unsigned seed = unsigned(data[0]) | unsigned(data[1]) << 8 | unsigned(data[2]) << 16 | unsigned(data[3]) << 24;
+    int size = data[4] < 192 ? 4 + data[4] % 13 : 4 + data[4] % 61;
+    return with_snake(size, seed, [&](auto &dispatched) {
+        Snake reference(size, seed);
+        Packed_snake packed(size, seed);
+        Bit_snake bits(size, seed);
+        Linked_snake linked(size, seed);
+        Checked_cells checked;
+        auto check = [&](int tick) {
+            if (const char *what = difference(reference, packed, checked))
+                diverged("Packed_snake", what, tick, size, seed);
+            if (const char *what = difference(reference, bits, checked))
+                diverged("Bit_snake", what, tick, size, seed);
+            if (const char *what = difference(reference, linked, checked))
+                diverged("Linked_snake", what, tick, size, seed);
+            if (const char *what = difference(reference, dispatched, checked))
+                diverged("with_snake", what, tick, size, seed);
+        };
+        check(0);
+        long long ticks = 0;
+        for (std::size_t k = 5; k < length; k++) {
+            int code = data[k] & 7;
+            int tick = int(k - 4);
+            apply_action(reference, code);
+            apply_action(packed, code);
+            apply_action(bits, code);
+            apply_action(linked, code);
+            apply_action(dispatched, code);
+            Vector tail = reference.body.back();
+            Step_result expected = reference.step();
+            bool working = expected.working();
+            if (not same_step(expected, packed.step()))
+                diverged("Packed_snake", "step result", tick, size, seed);
+            if (not same_step(expected, bits.step()))
+                diverged("Bit_snake", "step result", tick, size, seed);
+            if (not same_step(expected, linked.step()))
+                diverged("Linked_snake", "step result", tick, size, seed);
+            if (not same_step(expected, dispatched.step()))
+                diverged("with_snake", "step result", tick, size, seed);
+            checked.all = not working or tick % Full_check_period == 0 or k + 1 == length;
+            checked.cells[0] = tail;
+            checked.cells[1] = reference.body[0];
+            checked.cells[2] = reference.field.apple;
+            check(tick);
+            if (not working) {
+                reference.new_game();
+                packed.new_game();
+                bits.new_game();
+                linked.new_game();
+                dispatched.new_game();
+                check(tick);
+            }
+            ticks++;
+        }
+        return ticks;
+    });
+}
+
+/** \brief libFuzzer entry point
+ *
+ * @param data - input bytes
+ * @param length - number of input bytes
+ * @return 0
+ */
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t *data, std::size_t length) {
+    play_input(data, length);
+    return 0;
+}
+
+#ifndef SNAKE_LIBFUZZER
+
+/** \brief standalone differential fuzzer of the engines.
+ *
+ * Without libFuzzer inputs are random bytes, or the given files, like saved crash inputs.
+ * Every divergence from Snake aborts with the engine, tick, size and seed.
+ * Command line options:
+ * --runs N - number of random inputs, 10000 by default.
+ * --seed S - seed of the random inputs, 1 by default.
+ * --length L - largest input in bytes, 4096 by default.
+ * Other arguments are input files, then no random inputs are played.
+ *
+ * @param argc - number of command line arguments
+ * @param argv - command line arguments
+ * @return 0 if no engine diverged, 2 if an input file can't be read
+ */
+int main(int argc, char *argv[]) {
+    long long runs = 10000;
+    unsigned seed = 1;
+    std::size_t longest = 4096;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        if (option == "--runs" and i + 1 < argc)
+            runs = std::atoll(argv[++i]);
+        else if (option == "--seed" and i + 1 < argc)
+            seed = unsigned(std::strtoul(argv[++i], nullptr, 10));
+        else if (option == "--length" and i + 1 < argc)
+            longest = std::size_t(std::max(6, std::atoi(argv[++i])));
+        else
+            files.push_back(option);
+    }
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start = Clock::now();
+    long long ticks = 0;
+    std::vector<std::uint8_t> input;
+    for (const std::string &path : files) {
+        std::FILE *in = std::fopen(path.c_str(), "rb");
+        if (in == nullptr) {
+            std::fprintf(stderr, "snake_fuzz: can't read %s\n", path.c_str());
+            return 2;
+        }
+        input.clear();
+        int c;
+        while ((c = std::fgetc(in)) != EOF)
+            input.push_back(std::uint8_t(c));
+        std::fclose(in);
+        ticks += play_input(input.data(), input.size());
+    }
+    if (files.empty()) {
+        std::default_random_engine engine(seed);
+        std::uniform_int_distribution<std::size_t> input_length(5, longest);
+        std::uniform_int_distribution<int> byte(0, 255);
+        for (long long run = 0; run < runs; run++) {
+            input.resize(input_length(engine));
+            for (std::uint8_t &value : input)
+                value = std::uint8_t(byte(engine));
+            ticks += play_input(input.data(), input.size());
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::printf("%lld ticks in %.2f s, %.3g ticks/s, no divergence\n", ticks, seconds,
+                seconds > 0 ? double(ticks) / seconds : 0.);
+    return 0;
+}
+
+#endif
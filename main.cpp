@@ -4,62 +4,130 @@
 #include <SFML/Window/Keyboard.hpp>
 #include <SFML/Window/Event.hpp>
 #include <random>
+#include <iostream>
+#include <cstdlib>
+#include <algorithm>
+#include <memory>
 #include "windows.h"
 #include "Snake.h"
+#include "Input.h"
+#include "Usage.h"
+#include "Atlas.h"
+#include "Camera.h"
+#include "Render.h"
+#include "Mosaic.h"
+#include "Recorder.h"
+#include "Hud.h"
 
-/** \brief manage sprites push them to window.
+/** \brief rectangle of atlas image
  *
- * Set new texture to every sprite every tick according to field state.
+ * @param tile - index of image in atlas_rects
+ * @return texture rectangle of the image
+ */
+sf::IntRect atlas_rect(int tile) {
+    return sf::IntRect(int(atlas_rects[tile][0]), int(atlas_rects[tile][1]),
+                       int(atlas_rects[tile][2]), int(atlas_rects[tile][3]));
+}
+
+/** \brief push board seen by the camera and minimap to window.
  *
  * @param snake - Snake object
- * @param window - Window for pushing sprites
- * @param sprites - global sprite matrix
+ * @param camera - camera over the field
+ * @param window - Window for pushing cells
+ * @param board - renderer of visible cells
+ * @param minimap - overview of the board, shown when the board doesn't fit the view
+ * @param hud - statistics overlay, nullptr if hidden
  */
-void draw(Snake snake, sf::RenderWindow *window, std::vector<std::vector<sf::Sprite>> &sprites) {
-    sf::Texture snake_texture, wall_texture, empty_texture, apple_texture;
-    snake_texture.loadFromFile("snake.jpg");
-    wall_texture.loadFromFile("wall.jpg");
-    empty_texture.loadFromFile("empty.jpg");
-    apple_texture.loadFromFile("apple.jpg");
-    for (int i = 0; i < snake.field.size; i++) {
-        for (int j = 0; j < snake.field.size; j++) {
-            switch (snake.field.body[i][j]) {
-                case Wall_id:
-                    sprites[i][j].setTexture(wall_texture);
-                    break;
-                case Snake_id:
-                    sprites[i][j].setTexture(snake_texture);
-                    break;
-                case Empty_id:
-                    sprites[i][j].setTexture(empty_texture);
-                    break;
-                case Apple_id:
-                    sprites[i][j].setTexture(apple_texture);
-                    break;
-            }
+void draw(const Snake &snake, const Camera &camera, sf::RenderWindow *window, Board_renderer &board,
+          Minimap &minimap, const Hud *hud) {
+    window->clear();
+    board.draw(snake.field, camera, *window);
+    window->setView(window->getDefaultView());
+    if (camera.view_width() < float(snake.field.size) or camera.view_height() < float(snake.field.size))
+        minimap.draw(snake.field, snake.body[0], camera, *window);
+    if (hud != nullptr)
+        hud->draw(*window);
+    window->display();
+}
+
+/** \brief spectator loop that shows many bot games at once.
+ *
+ * Frames are drawn at 60 frames per second. Like the game, small boards move once in
+ * several frames, games are staggered over the frames and restart when they end.
+ *
+ * @param window - Window for pushing boards
+ * @param atlas - texture made from atlas_pixels
+ * @param count - number of games
+ * @param size - size of every field
+ * @return 0 if program is finished
+ */
+int spectate(sf::RenderWindow &window, const sf::Texture &atlas, int count, int size) {
+    Mosaic mosaic(atlas, count, size, std::max(1, 100 / size));
+    window.setFramerateLimit(60);
+    sf::Event event;
+    sf::Clock clock;
+    int frames = 0;
+    while (window.isOpen()) {
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed)
+                window.close();
         }
-    }
-    for (int i = 0; i < snake.field.size; i++) {
-        for (int j = 0; j < snake.field.size; j++) {
-            window->draw(sprites[i][j]);
+        mosaic.tick();
+        window.clear();
+        mosaic.draw(window);
+        window.display();
+        frames++;
+        if (clock.getElapsedTime().asSeconds() >= 5.f) {
+            std::cout << "spectate: " << float(frames) / clock.restart().asSeconds() << " fps" << std::endl;
+            frames = 0;
         }
     }
-    window->display();
+    return 0;
 }
 
 /** \brief main function with cycle for game.
  *
- * Initialize window, game and global sprite matrix. Process events from player's input. Process game running.
+ * Initialize window, game, camera and renderers. Process events from player's input. Process game running.
+ * While the game is over the loop blocks on window events and redraws the play button
+ * only when it is entered, resized or focused.
+ * Command line options:
+ * --cpu-usage - print CPU usage of menu and game states at exit.
+ * --startup-time - print time from process launch to first frame.
+ * --size N - size of the field, 10 by default.
+ * --spectate K - watch K bot games on fields of the given size instead of playing.
+ * --record DIR - save every tick as PPM image into existing directory DIR.
+ * Keys + and - or mouse wheel zoom the camera, H toggles statistics overlay.
  *
+ * @param argc - number of command line arguments
+ * @param argv - command line arguments
  * @return 0 if program is finished
  */
-int main() {
-    const int n = 10;
+int main(int argc, char *argv[]) {
+    bool cpu_usage = false;
+    bool startup_time = false;
+    int n = 10;
+    int spectators = 0;
+    std::string record;
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--cpu-usage")
+            cpu_usage = true;
+        else if (std::string(argv[i]) == "--startup-time")
+            startup_time = true;
+        else if (std::string(argv[i]) == "--size" and i + 1 < argc)
+            n = std::max(6, std::atoi(argv[++i]));
+        else if (std::string(argv[i]) == "--spectate" and i + 1 < argc)
+            spectators = std::max(1, std::atoi(argv[++i]));
+        else if (std::string(argv[i]) == "--record" and i + 1 < argc)
+            record = argv[++i];
+    }
     sf::RenderWindow window;
     window.create(sf::VideoMode(640, 640), "My window");
-    sf::Texture texture;
-    texture.loadFromFile("play_button.jpg");
-    sf::Sprite sprite(texture);
+    sf::Texture atlas;
+    atlas.create(atlas_width, atlas_height);
+    atlas.update(atlas_pixels);
+    if (spectators > 0)
+        return spectate(window, atlas, spectators, n);
+    sf::Sprite sprite(atlas, atlas_rect(Play_button_tile));
     sf::Rect sprite_rect = sprite.getTextureRect();
     unsigned int button_x = (window.getSize().x - sprite_rect.width) / 2;
     unsigned int button_y = (window.getSize().y - sprite_rect.height) / 2;
@@ -67,51 +135,152 @@ int main() {
     sprite_rect.top = button_y;
     sprite.setPosition(button_x, button_y);
     Snake snake(n);
-    std::vector<std::vector<sf::Sprite>> sprites;
-    for (int i = 0; i < n; i++) {
-        std::vector<sf::Sprite> sprite_column;
-        for (int j = 0; j < n; j++) {
-            sprite_column.emplace_back();
-            sprite_column[j].setPosition(10.f / float(n) * 64 * i, 10.f / float(n) * 64 * j);
-            sprite_column[j].scale(sf::Vector2f(10.f / float(n), 10.f / float(n)));
-        }
-        sprites.push_back(sprite_column);
+    Camera camera(n, float(window.getSize().x), float(window.getSize().y));
+    Board_renderer board(atlas);
+    Minimap minimap(window.getSize().x);
+    int ticks_every = std::max(1, 100 / n);
+
+    std::unique_ptr<Tile_set> tiles;
+    std::unique_ptr<Rasterizer> rasterizer;
+    std::unique_ptr<Recorder> recorder;
+    Latency_stats capture;
+    long long tick = 0;
+
+    Hud hud;
+    bool show_hud = true;
+    Rolling_window frame_times(240);
+    auto period_begin = std::chrono::steady_clock::now();
+    int period_frames = 0, period_ticks = 0;
+    if (not record.empty()) {
+        tiles = std::make_unique<Tile_set>(atlas_pixels, atlas_width, atlas_rects, std::clamp(640 / n, 1, 64));
+        rasterizer = std::make_unique<Rasterizer>(*tiles);
+        int side = rasterizer->frame_size(snake.field);
+        recorder = std::make_unique<Recorder>(side, side, ppm_files(record));
     }
 
     bool working = snake.move();
     bool game = true;
     sf::Event event;
+    Input_queue input;
+
+    camera.follow(snake.body[0]);
+    draw(snake, camera, &window, board, minimap, nullptr);
+    if (startup_time)
+        std::cout << "startup: " << process_uptime() * 1000. << " ms" << std::endl;
 
     int cycle = 0;
+    bool redraw = false;
+    Cpu_usage game_usage, menu_usage;
+    game_usage.start();
     while (working) {
-        bool happen = window.pollEvent(event);
-        if (game) {
-            Sleep(32);
-            if (cycle == 100 / snake.field.size - 1)
-                game = snake.move();
-            draw(snake, &window, sprites);
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::W)) { snake.up(); }
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::A)) { snake.left(); }
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::D)) { snake.right(); }
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::S)) { snake.down(); }
-            cycle = (cycle + 1) % (100 / snake.field.size);
-            if (not game)
-                draw(snake, &window, sprites);
-        } else {
+        if (not game and redraw) {
             window.draw(sprite);
             window.display();
-            if (happen and event.type == sf::Event::MouseButtonPressed and
-                sf::Mouse::isButtonPressed(sf::Mouse::Left)) {
-                sf::Vector2 pos = sf::Mouse::getPosition(window);
-                if (sprite_rect.contains(pos)) {
-                    game = snake.new_game();
+            redraw = false;
+        }
+        bool clicked = false;
+        bool happen = game ? window.pollEvent(event) : window.waitEvent(event);
+        for (; happen; happen = window.pollEvent(event)) {
+            auto stamp = std::chrono::steady_clock::now();
+            if (event.type == sf::Event::Closed) {
+                window.close();
+                working = false;
+            } else if (event.type == sf::Event::Resized or event.type == sf::Event::GainedFocus) {
+                redraw = true;
+            } else if (event.type == sf::Event::KeyPressed and game) {
+                switch (event.key.code) {
+                    case sf::Keyboard::W:
+                        input.push(Vector(0, -1), stamp);
+                        break;
+                    case sf::Keyboard::A:
+                        input.push(Vector(-1, 0), stamp);
+                        break;
+                    case sf::Keyboard::D:
+                        input.push(Vector(1, 0), stamp);
+                        break;
+                    case sf::Keyboard::S:
+                        input.push(Vector(0, 1), stamp);
+                        break;
+                    case sf::Keyboard::Add:
+                    case sf::Keyboard::Equal:
+                        camera.zoom(2.f);
+                        break;
+                    case sf::Keyboard::Subtract:
+                    case sf::Keyboard::Hyphen:
+                        camera.zoom(.5f);
+                        break;
+                    case sf::Keyboard::H:
+                        show_hud = not show_hud;
+                        break;
+                    default:
+                        break;
                 }
+            } else if (event.type == sf::Event::MouseWheelScrolled and game) {
+                camera.zoom(event.mouseWheelScroll.delta > 0 ? 1.25f : .8f);
+            } else if (event.type == sf::Event::MouseButtonPressed and
+                       event.mouseButton.button == sf::Mouse::Left and
+                       sprite_rect.contains(event.mouseButton.x, event.mouseButton.y)) {
+                clicked = true;
             }
         }
-        if (happen and event.type == sf::Event::Closed) {
-            window.close();
-            working = false;
+        if (not working)
+            break;
+        if (game) {
+            Sleep(32);
+            auto frame_begin = std::chrono::steady_clock::now();
+            if (cycle == ticks_every - 1) {
+                input.apply(snake, std::chrono::steady_clock::now());
+                game = snake.move();
+                if (recorder) {
+                    auto begin = std::chrono::steady_clock::now();
+                    Frame *frame = recorder->acquire(tick);
+                    if (frame != nullptr) {
+                        rasterizer->render(snake.field, frame->pixels.data());
+                        recorder->submit(frame);
+                    }
+                    capture.add(std::chrono::steady_clock::now() - begin);
+                }
+                tick++;
+                period_ticks++;
+            }
+            camera.follow(snake.body[0]);
+            draw(snake, camera, &window, board, minimap, show_hud ? &hud : nullptr);
+            cycle = (cycle + 1) % ticks_every;
+
+            auto frame_end = std::chrono::steady_clock::now();
+            frame_times.add(std::chrono::duration<double, std::milli>(frame_end - frame_begin).count());
+            period_frames++;
+            double period = std::chrono::duration<double>(frame_end - period_begin).count();
+            if (period >= .25) {
+                hud.set(int(snake.body.size()), period_ticks / period, period_frames / period,
+                        frame_times.percentile(50), frame_times.percentile(99));
+                period_begin = frame_end;
+                period_frames = 0;
+                period_ticks = 0;
+            }
+            if (not game) {
+                redraw = true;
+                game_usage.stop();
+                menu_usage.start();
+            }
+        } else if (clicked) {
+            input.clear();
+            game = snake.new_game();
+            menu_usage.stop();
+            game_usage.start();
         }
     }
+    game_usage.stop();
+    menu_usage.stop();
+    std::cout << "input-to-move latency: " << input.latency << std::endl;
+    if (recorder) {
+        recorder->finish();
+        std::cout << "recorded " << recorder->written << " frames, dropped " << recorder->dropped
+                  << ", failed " << recorder->failed << ", game thread cost: " << capture << std::endl;
+    }
+    if (cpu_usage) {
+        std::cout << "game: " << game_usage << std::endl;
+        std::cout << "menu: " << menu_usage << std::endl;
+    }
     return 0;
-}
\ No newline at end of file
+}
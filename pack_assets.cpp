@@ -0,0 +1,60 @@
+#include <SFML/Graphics.hpp>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+/** \brief build step that packs textures into one RGBA atlas.
+ *
+ * Decodes the images given on the command line and writes a header with the atlas pixels
+ * and the rectangle of every image. Images are placed in one row in the given order,
+ * so the game decodes nothing at startup.
+ * Usage: pack_assets output.h image...
+ *
+ * @param argc - number of command line arguments
+ * @param argv - command line arguments
+ * @return 0 if the header is written, 1 otherwise
+ */
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        std::cerr << "usage: pack_assets output.h image..." << std::endl;
+        return 1;
+    }
+    std::vector<sf::Image> images(argc - 2);
+    unsigned width = 0, height = 0;
+    for (int i = 0; i < argc - 2; i++) {
+        if (not images[i].loadFromFile(argv[i + 2])) {
+            std::cerr << "pack_assets: can't decode " << argv[i + 2] << std::endl;
+            return 1;
+        }
+        width += images[i].getSize().x;
+        height = std::max(height, images[i].getSize().y);
+    }
+    sf::Image atlas;
+    atlas.create(width, height, sf::Color::Black);
+    std::ofstream out(argv[1]);
+    out << "//generated by pack_assets, do not edit\n";
+    out << "#ifndef CPPPRJ_ATLAS_DATA_H\n#define CPPPRJ_ATLAS_DATA_H\n\n";
+    out << "///number of packed images\nconstexpr int atlas_count = " << images.size() << ";\n";
+    out << "///width of the atlas in pixels\nconstexpr unsigned atlas_width = " << width << ";\n";
+    out << "///height of the atlas in pixels\nconstexpr unsigned atlas_height = " << height << ";\n";
+    out << "///left, top, width and height of every packed image\n";
+    out << "constexpr unsigned atlas_rects[atlas_count][4] = {\n";
+    unsigned left = 0;
+    for (auto &image : images) {
+        atlas.copy(image, left, 0);
+        out << "        {" << left << ", 0, " << image.getSize().x << ", " << image.getSize().y << "},\n";
+        left += image.getSize().x;
+    }
+    out << "};\n";
+    out << "///RGBA pixels of the atlas, row by row\n";
+    out << "alignas(4) constexpr unsigned char atlas_pixels[] = {";
+    const sf::Uint8 *pixels = atlas.getPixelsPtr();
+    for (unsigned i = 0; i < width * height * 4; i++) {
+        if (i % 32 == 0)
+            out << "\n        ";
+        out << unsigned(pixels[i]) << ",";
+    }
+    out << "\n};\n\n#endif //CPPPRJ_ATLAS_DATA_H\n";
+    return out ? 0 : 1;
+}
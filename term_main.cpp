@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include "Snake.h"
+#include "Bot.h"
+#include "Terminal.h"
+
+/** \brief watch bot games in a terminal, for example over SSH.
+ *
+ * Command line options:
+ * --size N - size of the field, 20 by default.
+ * --fps N - frames per second, 15 by default.
+ * --frames N - number of frames, 0 (default) or less runs forever.
+ * --seed N - seed of the game and the bot.
+ * Bytes per frame are shown below the board once per second and printed at exit.
+ *
+ * @param argc - number of command line arguments
+ * @param argv - command line arguments
+ * @return 0 if program is finished
+ */
+int main(int argc, char *argv[]) {
+    int size = 20, fps = 15;
+    long long frames = 0;
+    unsigned seed = std::random_device()();
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string option = argv[i];
+        if (option == "--size")
+            size = std::max(6, std::atoi(argv[i + 1]));
+        else if (option == "--fps")
+            fps = std::max(1, std::atoi(argv[i + 1]));
+        else if (option == "--frames")
+            frames = std::max(0LL, std::atoll(argv[i + 1]));
+        else if (option == "--seed")
+            seed = unsigned(std::strtoul(argv[i + 1], nullptr, 10));
+    }
+
+    Snake snake(size, seed);
+    std::default_random_engine bot_engine(seed);
+    Terminal_renderer terminal;
+    auto period = std::chrono::microseconds(1000000 / fps);
+    auto next = std::chrono::steady_clock::now();
+    for (long long k = 0; frames == 0 or k < frames; k++) {
+        bot_turn(snake, bot_engine);
+        if (not snake.move())
+            snake.new_game();
+        terminal.render(snake.field);
+        if (not terminal.flush())
+            return 1;
+        if (k % fps == 0) {
+            std::string status = "\x1b[" + std::to_string(size + 1) + ";1H\x1b[2K" +
+                                 std::to_string(terminal.last_bytes) + " bytes/frame, mean " +
+                                 std::to_string(terminal.total_bytes / terminal.frames);
+            Terminal_renderer::write_all(1, status);
+        }
+        next += period;
+        std::this_thread::sleep_until(next);
+    }
+    Terminal_renderer::write_all(1, terminal.finish());
+    if (terminal.frames > 0)
+        std::fprintf(stderr, "snake_term: %lld frames, %.1f bytes/frame\n", terminal.frames,
+                     double(terminal.total_bytes) / double(terminal.frames));
+    return 0;
+}
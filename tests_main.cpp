@@ -2,9 +2,66 @@
 
 #include "doctest/doctest.h"
 #include "Snake.h"
+#include "Input.h"
+#include "Camera.h"
+#include "Bot.h"
+#include "Raster.h"
+#include "Recorder.h"
+#include "Terminal.h"
+#include "Linked_snake.h"
+#include "Packed_field.h"
+#include "Bit_field.h"
+#include "Fixed_field.h"
+#include "Bench_compare.h"
+#include "Perf_counters.h"
+#include "Checksum.h"
+#include "Batch.h"
+#include "Arena.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
 
-TEST_CASE("Direction check") {
-    Snake snake(10);
+///heap allocations of the test binary, counted by the replaced global operator new
+std::atomic<long long> allocation_count{0};
+
+//replacements aren't inlined, so g++ -Wall doesn't pair inlined malloc() and free() with new and delete
+#ifdef _MSC_VER
+#define NOINLINE __declspec(noinline)
+#else
+#define NOINLINE __attribute__((noinline))
+#endif
+
+NOINLINE void *operator new(std::size_t bytes) {
+    allocation_count++;
+    if (void *memory = std::malloc(bytes == 0 ? 1 : bytes))
+        return memory;
+    throw std::bad_alloc();
+}
+
+NOINLINE void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+NOINLINE void operator delete(void *memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+/** \brief count heap allocations made while function runs
+ *
+ * Doctest macros allocate, so they must not be called inside.
+ *
+ * @param function - callable without arguments
+ * @return number of allocations
+ */
+template<class Function>
+long long allocations(Function &&function) {
+    long long before = allocation_count;
+    function();
+    return allocation_count - before;
+}
+
+TEST_CASE_TEMPLATE("Direction check", Game, Snake, Packed_snake, Bit_snake, Fixed_snake<10>) {
+    Game snake(10);
     CHECK (snake.delta == Vector(0, -1));
     snake.left();
     CHECK (snake.delta == Vector(-1, 0));
@@ -17,8 +74,8 @@ TEST_CASE("Direction check") {
     CHECK (snake.delta == Vector(0, 1));
 }
 
-TEST_CASE("Eating apple check") {
-    Snake snake(10);
+TEST_CASE_TEMPLATE("Eating apple check", Game, Snake, Packed_snake, Bit_snake, Fixed_snake<10>) {
+    Game snake(10);
     Vector next = snake.body[0] + snake.delta;
     Vector tail = snake.body[snake.body.size() - 1];
     snake.field.body[next.x][next.y] = Apple_id;
@@ -32,8 +89,8 @@ TEST_CASE("Eating apple check") {
     CHECK(tail == snake.body[snake.body.size() - 1]);
 }
 
-TEST_CASE("Wall crush check") {
-    Snake snake(6);
+TEST_CASE_TEMPLATE("Wall crush check", Game, Snake, Packed_snake, Bit_snake, Fixed_snake<6>) {
+    Game snake(6);
     Vector next = snake.body[0] + snake.delta;
     CHECK(snake.move() == true);
     CHECK(snake.body[0] == next);
@@ -44,8 +101,8 @@ TEST_CASE("Wall crush check") {
     CHECK(snake.body[0] == next);
 }
 
-TEST_CASE("Troubleproof move check") {
-    Snake snake(6);
+TEST_CASE_TEMPLATE("Troubleproof move check", Game, Snake, Packed_snake, Bit_snake, Fixed_snake<6>) {
+    Game snake(6);
     Vector next = snake.body[0] + snake.delta;
     snake.base_move();
     CHECK(snake.body[0] == next);
@@ -58,8 +115,8 @@ TEST_CASE("Troubleproof move check") {
     CHECK(snake.body[0] == next);
 }
 
-TEST_CASE("Self crush check") {
-    Snake snake(10);
+TEST_CASE_TEMPLATE("Self crush check", Game, Snake, Packed_snake, Bit_snake, Fixed_snake<10>) {
+    Game snake(10);
     Vector next = snake.body[0] + snake.delta;
     snake.field.body[next.x][next.y] = Apple_id;
     CHECK(snake.move());
@@ -75,11 +132,11 @@ TEST_CASE("Self crush check") {
     CHECK(snake.move() == false);
 }
 
-TEST_CASE("Win check") {
-    Snake snake(6);
+TEST_CASE_TEMPLATE("Win check", Game, Snake, Packed_snake, Bit_snake, Fixed_snake<6>) {
+    Game snake(6);
     Vector next = snake.body[0] + snake.delta;
-    for (int i = 1; i < snake.field.body.size() - 1; i++)
-        for (int j = 1; j < snake.field.body[0].size() - 1; j++)
+    for (int i = 1; i < snake.field.size - 1; i++)
+        for (int j = 1; j < snake.field.size - 1; j++)
             if (snake.field.body[i][j] != Snake_id and Vector(i, j) != next) {
                 snake.field.body[i][j] = Snake_id;
                 snake.body.emplace_back(i, j);
@@ -89,8 +146,54 @@ TEST_CASE("Win check") {
     CHECK(not snake.move());
 }
 
-TEST_CASE("Apple gen check") {
-    Snake snake(6);
+TEST_CASE_TEMPLATE("Step result check", Game, Snake, Packed_snake, Bit_snake, Fixed_snake<6>) {
+    Game snake(6);
+    Vector head = snake.body[0];
+    snake.field.body[head.x][head.y - 1] = Apple_id;
+    Step_result result = snake.step();
+    CHECK(result.event == Ate_event);
+    CHECK(result.ate);
+    CHECK(result.length == 3);
+    CHECK(result.apple == snake.field.apple);
+    CHECK(snake.field.body[result.apple.x][result.apple.y] == Apple_id);
+    CHECK(snake.step().working());
+    head = snake.body[0];
+    result = snake.step();
+    CHECK(result.event == Wall_event);
+    CHECK(not result.ate);
+    CHECK(not result.working());
+    CHECK(snake.body[0] == head);
+
+    Game curled(6);
+    for (int k = 0; k < 3; k++) {
+        if (k == 1)
+            curled.left();
+        if (k == 2)
+            curled.down();
+        Vector next = curled.body[0] + curled.delta;
+        curled.field.body[next.x][next.y] = Apple_id;
+        CHECK(curled.step().event == Ate_event);
+    }
+    curled.right();
+    CHECK(curled.step().event == Self_event);
+
+    Game full(6);
+    Vector next = full.body[0] + full.delta;
+    for (int i = 1; i < 5; i++)
+        for (int j = 1; j < 5; j++)
+            if (full.field.body[i][j] != Snake_id and Vector(i, j) != next) {
+                full.field.body[i][j] = Snake_id;
+                full.body.emplace_back(i, j);
+            }
+    full.field.body[next.x][next.y] = Apple_id;
+    result = full.step();
+    CHECK(result.event == Won_event);
+    CHECK(result.ate);
+    CHECK(result.length == 16);
+}
+
+TEST_CASE_TEMPLATE("Apple gen check", Game, Snake, Packed_snake, Bit_snake, Fixed_snake<6>) {
+    Game snake(6);
     Vector head = snake.body[0];
     Vector tail = snake.body[1];
     for (int i = 0; i < 13; i++) { //одно из яблок генерируется автоматически при создании экземпляра класса Field
@@ -102,13 +205,13 @@ TEST_CASE("Apple gen check") {
                 CHECK(snake.field.body[i][j] == Apple_id);
 }
 
-TEST_CASE("Restart check") {
-    Snake snake(6);
+TEST_CASE_TEMPLATE("Restart check", Game, Snake, Packed_snake, Bit_snake, Fixed_snake<6>) {
+    Game snake(6);
     Vector head = snake.body[0];
     Vector tail = snake.body[1];
     snake.left();
-    for (int i = 1; i < snake.field.body.size() - 1; i++)
-        for (int j = 1; j < snake.field.body[0].size() - 1; j++)
+    for (int i = 1; i < snake.field.size - 1; i++)
+        for (int j = 1; j < snake.field.size - 1; j++)
             if (snake.field.body[i][j] != Snake_id) {
                 snake.field.body[i][j] = Snake_id;
                 snake.body.emplace_back(i, j);
@@ -124,3 +227,739 @@ TEST_CASE("Restart check") {
     CHECK(snake.field.body[head.x][head.y] == Snake_id);
     CHECK(snake.field.body[tail.x][tail.y] == Snake_id);
 }
+
+TEST_CASE("Turn buffering check") {
+    Snake snake(10);
+    Input_queue input;
+    auto now = std::chrono::steady_clock::now();
+    CHECK(input.push(Vector(-1, 0), now));
+    CHECK(input.push(Vector(0, 1), now));
+    CHECK(not input.push(Vector(0, 1), now));
+    CHECK(input.apply(snake, now));
+    CHECK(snake.delta == Vector(-1, 0));
+    snake.move();
+    CHECK(input.apply(snake, now));
+    CHECK(snake.delta == Vector(0, 1));
+    CHECK(not input.apply(snake, now));
+    CHECK(input.latency.count == 2);
+}
+
+TEST_CASE("Turn repeat check") {
+    Snake snake(10);
+    Input_queue input;
+    auto now = std::chrono::steady_clock::now();
+    CHECK(input.push(Vector(0, -1), now));
+    CHECK(input.push(Vector(1, 0), now));
+    CHECK(input.apply(snake, now));
+    CHECK(snake.delta == Vector(1, 0));
+    CHECK(input.size() == 0);
+    snake.move();
+    CHECK(input.push(Vector(1, 0), now));
+    CHECK(not input.apply(snake, now));
+    CHECK(input.size() == 0);
+    CHECK(input.latency.count == 1);
+}
+
+TEST_CASE("Turn queue bounds check") {
+    Snake snake(10);
+    Input_queue input;
+    auto now = std::chrono::steady_clock::now();
+    CHECK(input.push(Vector(0, 1), now));
+    CHECK(input.push(Vector(1, 0), now));
+    CHECK(input.push(Vector(0, 1), now));
+    CHECK(input.push(Vector(-1, 0), now));
+    CHECK(not input.push(Vector(0, 1), now));
+    CHECK(input.dropped == 1);
+    CHECK(input.apply(snake, now));
+    CHECK(snake.delta == Vector(1, 0));
+    CHECK(input.size() == 2);
+}
+
+TEST_CASE("Camera fit check") {
+    Camera camera(10, 640, 640);
+    CHECK(camera.cell == 64);
+    camera.follow(Vector(1, 1));
+    Cell_range range = camera.visible();
+    CHECK(range.first_x == 0);
+    CHECK(range.last_x == 10);
+    CHECK(range.first_y == 0);
+    CHECK(range.last_y == 10);
+}
+
+TEST_CASE("Camera culling check") {
+    Camera camera(10000, 640, 640);
+    CHECK(camera.cell == Camera::min_cell);
+    camera.follow(Vector(5000, 5000));
+    Cell_range range = camera.visible();
+    CHECK(range.count() <= 161 * 161);
+    CHECK(range.first_x <= 5000);
+    CHECK(range.last_x > 5000);
+    camera.follow(Vector(0, 9999));
+    range = camera.visible();
+    CHECK(range.first_x == 0);
+    CHECK(range.last_y == 10000);
+    camera.zoom(4);
+    CHECK(camera.visible().count() <= 41 * 41);
+}
+
+TEST_CASE("Bot safety check") {
+    Snake snake(6);
+    std::default_random_engine engine(1);
+    snake.move();
+    snake.move();
+    CHECK(not is_safe(snake, snake.delta));
+    CHECK(is_safe(snake, Vector(1, 0)));
+    bot_turn(snake, engine);
+    CHECK(snake.delta != Vector(0, -1));
+    CHECK(snake.move());
+}
+
+TEST_CASE("Workers chunk check") {
+    Workers workers(3);
+    std::vector<std::atomic<int>> visits(64);
+    bool once = true;
+    for (int round = 0; round < 20000; round++) {
+        int count = 1 + round % 64;
+        for (int k = 0; k < count; k++)
+            visits[k] = 0;
+        auto job = [&](int begin, int end) {
+            for (int k = begin; k < end; k++)
+                visits[k]++;
+        };
+        if (round % 2 == 0) {
+            workers.start(count, job);
+            workers.wait();
+        } else
+            workers.parallel_for(count, job);
+        for (int k = 0; k < count; k++)
+            once = once and visits[k] == 1;
+    }
+    CHECK(once);
+}
+
+TEST_CASE("Rasterizer check") {
+    const unsigned rects[4][4] = {{0, 0, 2, 2}, {2, 0, 2, 2}, {4, 0, 2, 2}, {6, 0, 2, 2}};
+    std::vector<unsigned char> atlas(8 * 2 * 4);
+    for (int x = 0; x < 8; x++)
+        for (int y = 0; y < 2; y++)
+            atlas[(y * 8 + x) * 4] = (unsigned char) (x / 2 * 10 + 1);
+    Tile_set tiles(atlas.data(), 8, rects, 3);
+    Snake snake(6);
+    Rasterizer rasterizer(tiles, 2);
+    int side = rasterizer.frame_size(snake.field);
+    CHECK(side == 18);
+    std::vector<unsigned char> frame(side * side * 3);
+    rasterizer.render(snake.field, frame.data());
+    for (int i = 0; i < 6; i++)
+        for (int j = 0; j < 6; j++)
+            CHECK(frame[((j * 3 + 2) * side + i * 3 + 1) * 3] == snake.field.body[i][j] * 10 + 1);
+}
+
+TEST_CASE("Recorder backpressure check") {
+    std::mutex gate;
+    gate.lock();
+    int encoded = 0;
+    Recorder recorder(4, 4, [&](const Frame &frame) {
+        std::lock_guard<std::mutex> lock(gate);
+        encoded++;
+        return frame.pixels.size() == 48;
+    }, 2, 1);
+    Frame *first = recorder.acquire(0);
+    Frame *second = recorder.acquire(1);
+    REQUIRE(first != nullptr);
+    REQUIRE(second != nullptr);
+    CHECK(recorder.acquire(2) == nullptr);
+    CHECK(recorder.dropped == 1);
+    recorder.submit(first);
+    recorder.submit(second);
+    gate.unlock();
+    recorder.finish();
+    CHECK(recorder.written == 2);
+    CHECK(encoded == 2);
+}
+
+TEST_CASE("Terminal diff check") {
+    Snake snake(10);
+    Vector next = snake.body[0] + snake.delta;
+    snake.field.body[next.x][next.y] = Empty_id;
+    Terminal_renderer terminal;
+    std::size_t full = terminal.render(snake.field).size();
+    CHECK(terminal.render(snake.field).empty());
+    Vector tail = snake.body[1];
+    snake.move();
+    std::string diff = terminal.render(snake.field);
+    CHECK(diff.size() < full / 10);
+    CHECK(diff.find("\x1b[" + std::to_string(tail.y + 1) + ";" + std::to_string(2 * tail.x + 1) + "H") !=
+          std::string::npos);
+    CHECK(terminal.frames == 3);
+}
+
+TEST_CASE("Rolling percentile check") {
+    Rolling_window window(100);
+    CHECK(window.percentile(50) == 0);
+    for (int i = 1; i <= 150; i++)
+        window.add(i);
+    CHECK(window.size() == 100);
+    CHECK(window.percentile(50) == 100);
+    CHECK(window.percentile(99) == 149);
+    CHECK(window.percentile(100) == 150);
+    CHECK(window.percentile(0) == 51);
+}
+
+TEST_CASE("Linked engine lockstep check") {
+    for (unsigned seed = 0; seed < 20; seed++) {
+        int size = 6 + seed % 5;
+        Snake snake(size, seed);
+        Linked_snake linked(size, seed);
+        std::default_random_engine engine(seed);
+        std::uniform_int_distribution<int> turn(0, 4);
+        for (int tick = 0; tick < 2000; tick++) {
+            switch (turn(engine)) {
+                case 0: snake.up(); linked.up(); break;
+                case 1: snake.right(); linked.right(); break;
+                case 2: snake.down(); linked.down(); break;
+                case 3: snake.left(); linked.left(); break;
+                default: break;
+            }
+            Step_result expected = snake.step();
+            Step_result result = linked.step();
+            REQUIRE(int(result.event) == int(expected.event));
+            REQUIRE(result.ate == expected.ate);
+            REQUIRE(result.length == expected.length);
+            REQUIRE(result.apple == expected.apple);
+            if (not expected.working()) {
+                snake.new_game();
+                linked.new_game();
+            }
+            REQUIRE(linked.length() == int(snake.body.size()));
+            REQUIRE(linked.head() == snake.body[0]);
+            REQUIRE(linked.body() == snake.body);
+            bool same = true;
+            for (int i = 0; i < size; i++)
+                for (int j = 0; j < size; j++)
+                    same = same and linked.cell(i, j) == snake.field.body[i][j];
+            REQUIRE(same);
+        }
+    }
+}
+
+TEST_CASE("Packed grid bulk check") {
+    Packed_grid grid(10);
+    grid.reset();
+    CHECK(grid.count(Wall_id) == 36);
+    CHECK(grid.count(Empty_id) == 64);
+    CHECK(grid.bytes() == 32);
+    grid[3][4] = Snake_id;
+    grid[9][9] = Apple_id;
+    CHECK(grid[3][4] == Snake_id);
+    CHECK(grid.count(Snake_id) == 1);
+    CHECK(grid.count(Apple_id) == 1);
+    Packed_grid other(10);
+    other.reset();
+    CHECK(grid != other);
+    grid.clear_interior();
+    CHECK(grid.count(Snake_id) == 0);
+    CHECK(grid.count(Apple_id) == 1);
+    grid[9][9] = Wall_id;
+    CHECK(grid == other);
+}
+
+TEST_CASE_TEMPLATE("Field engine lockstep check", Game, Packed_snake, Bit_snake) {
+    for (unsigned seed = 0; seed < 20; seed++) {
+        int size = seed == 19 ? 64 : 6 + int(seed) * 3;
+        Snake snake(size, seed);
+        Game game(size, seed);
+        std::default_random_engine engine(seed);
+        std::uniform_int_distribution<int> turn(0, 4);
+        for (int tick = 0; tick < 2000; tick++) {
+            int code = turn(engine);
+            apply_action(snake, code);
+            apply_action(game, code);
+            bool working = snake.move();
+            REQUIRE(game.move() == working);
+            if (not working) {
+                snake.new_game();
+                game.new_game();
+            }
+            REQUIRE(game.body == snake.body);
+            bool same = true;
+            for (int i = 0; i < size; i++)
+                for (int j = 0; j < size; j++)
+                    same = same and game.field.body[i][j] == snake.field.body[i][j];
+            REQUIRE(same);
+        }
+    }
+}
+
+TEST_CASE("Bit flood fill and select check") {
+    for (int size : {6, 17, 64}) {
+        Field grid(size, 3);
+        Bit_field bits(size, 3);
+        std::default_random_engine engine(5);
+        std::uniform_int_distribution<int> coin(0, 2);
+        for (int x = 1; x < size - 1; x++)
+            for (int y = 1; y < size - 1; y++)
+                if (coin(engine) == 0) {
+                    grid.body[x][y] = Snake_id;
+                    bits.body[x][y] = Snake_id;
+                }
+        grid.create_apple();
+        bits.create_apple();
+        for (int x = 0; x < size; x++)
+            for (int y = 0; y < size; y++)
+                REQUIRE(bits.reachable_area(Vector(x, y)) == grid.reachable_area(Vector(x, y)));
+        CHECK(bits.reachable_area(Vector(0, 0)) == 0);
+        for (int k = 0; k < 200; k++) {
+            Vector cell = bits.random_empty_cell();
+            REQUIRE(bits.body[cell.x][cell.y] == Empty_id);
+        }
+        bits.body.snake.fill(0);
+        bits.body.apples.fill(0);
+        CHECK(bits.reachable_area(Vector(1, 1)) == (size - 2) * (size - 2));
+    }
+    Bit_field full(6, 1);
+    for (int x = 1; x < 5; x++)
+        for (int y = 1; y < 5; y++)
+            full.body[x][y] = Snake_id;
+    CHECK(full.random_empty_cell() == Vector(0, 0));
+    CHECK(select_bit(0b101100, 0) == 2);
+    CHECK(select_bit(0b101100, 2) == 5);
+    CHECK_THROWS_AS(Bit_snake(100), std::invalid_argument);
+    CHECK_NOTHROW(Bit_snake(64));
+}
+
+TEST_CASE("Fixed engine dispatch check") {
+    for (int size : {6, 8, 10, 12, 16, 32, 64}) {
+        unsigned seed = unsigned(size);
+        Snake snake(size, seed);
+        std::default_random_engine engine(seed), bot_engine(seed);
+        bool same = with_snake(size, seed, [&](auto &game) {
+            bool equal = true;
+            for (int tick = 0; tick < 3000; tick++) {
+                bot_turn(snake, bot_engine);
+                game.delta = snake.delta;
+                bool working = snake.move();
+                equal = equal and game.move() == working;
+                if (not working) {
+                    snake.new_game();
+                    game.new_game();
+                }
+                equal = equal and game.body == snake.body;
+                for (int i = 0; i < size; i++)
+                    for (int j = 0; j < size; j++)
+                        equal = equal and game.field.body[i][j] == snake.field.body[i][j];
+            }
+            return equal;
+        });
+        CHECK(same);
+    }
+    CHECK(with_snake(16, 1, [](auto &game) { return game.field.size; }) == 16);
+    CHECK_THROWS_AS(Fixed_snake<10>(12, 1), std::invalid_argument);
+    CHECK_NOTHROW(Fixed_snake<10>(10, 1));
+    CHECK(with_snake(17, 1, [](auto &game) { return game.field.size; }) == 17);
+}
+
+TEST_CASE("Linear board step check") {
+    Linear_board board(6);
+    board.place(3, 3);
+    CHECK(board.offsets[direction_code(Vector(1, 0))] == 6);
+    CHECK(board.position(board.head) == Vector(3, 3));
+    board.cells[board.index(3, 2)] = Apple_id;
+    CHECK(board.step(0) == Apple_id);
+    CHECK(board.length == 3);
+    CHECK(board.position(board.head) == Vector(3, 2));
+    CHECK(board.step(0) == Empty_id);
+    CHECK(board.step(0) == Wall_id);
+    CHECK(board.position(board.head) == Vector(3, 1));
+    CHECK(board.position(board.tail) == Vector(3, 3));
+    CHECK(board.step(3) == Empty_id);
+    CHECK(board.step(2) == Empty_id);
+    CHECK(board.step(1) == Empty_id);
+    CHECK(board.position(board.head) == Vector(3, 2));
+    CHECK(board.step(3) == Snake_id);
+    CHECK(board.position(board.head) == Vector(3, 2));
+    CHECK(board.length == 3);
+    board.clear();
+    board.place(3, 3);
+    board.cells[board.index(2, 3)] = Apple_id;
+    board.cells[board.index(2, 4)] = Apple_id;
+    CHECK(board.step(3) == Apple_id);
+    CHECK(board.step(2) == Apple_id);
+    CHECK(board.length == 4);
+    CHECK(board.step(1) == Empty_id);
+    CHECK(board.position(board.head) == Vector(3, 4));
+    CHECK(board.position(board.tail) == Vector(3, 3));
+    CHECK(board.at(board.index(3, 4)) == Snake_id);
+}
+
+TEST_CASE_TEMPLATE("Sparse reset check", Game, Snake, Packed_snake, Bit_snake, Fixed_snake<32>) {
+    Game snake(32, 4);
+    std::default_random_engine bot_engine(4);
+    for (int game = 0; game < 20; game++) {
+        while (true) {
+            bot_turn(snake, bot_engine);
+            if (not snake.move())
+                break;
+        }
+        snake.new_game();
+        int occupied = 0;
+        for (int i = 1; i < 31; i++)
+            for (int j = 1; j < 31; j++)
+                occupied += snake.field.body[i][j] != Empty_id;
+        REQUIRE(occupied == 3);
+    }
+}
+
+TEST_CASE("Benchmark comparison check") {
+    std::string text = "{\"repetitions\": 3, \"benchmarks\": [\n"
+                       "  {\"name\": \"snake/move/6\", \"ns_per_op\": 10, \"samples\": [10, 11, 9]},\n"
+                       "  {\"name\": \"snake/copy/6\", \"iterations\": 5, \"ns_per_op\": 200},\n"
+                       "  {\"name\": \"odd \\\"name\\\"\", \"extra\": {\"a\": [true, null]}, \"samples\": [1]}]}";
+    std::vector<Bench_samples> baseline;
+    REQUIRE(Bench_json_reader(text).read(baseline));
+    REQUIRE(baseline.size() == 3);
+    CHECK(baseline[0].samples == std::vector<double>{10, 11, 9});
+    CHECK(baseline[1].samples == std::vector<double>{200});
+    CHECK(baseline[2].name == "odd \"name\"");
+    std::vector<Bench_samples> broken;
+    CHECK(not Bench_json_reader("{\"benchmarks\": [{\"name\": \"x\", \"samples\": [1,]}]}").read(broken));
+    CHECK(not Bench_json_reader("{\"other\": 1}").read(broken));
+
+    std::vector<Bench_samples> current = {{"snake/move/6", {10.5, 9.5, 10.2}}, {"snake/copy/6", {300}}};
+    std::vector<Bench_change> changes = compare_runs(baseline, current, 0.1);
+    REQUIRE(changes.size() == 3);
+    CHECK(not changes[0].regressed);
+    CHECK(changes[0].low <= 1.);
+    CHECK(changes[0].high >= 1.);
+    CHECK(changes[1].regressed);
+    CHECK(changes[1].ratio == doctest::Approx(1.5));
+    CHECK(changes[2].missing);
+    CHECK(median({4, 1, 3, 2}) == 2.5);
+}
+
+TEST_CASE("Hardware counter check") {
+    Perf_counts first;
+    first.cycles = 100;
+    first.instructions = 250;
+    first.branch_misses = 4;
+    Perf_counts second = first;
+    second.branch_misses = -1;
+    first.add(second);
+    CHECK(first.cycles == 200);
+    CHECK(first.ipc() == doctest::Approx(2.5));
+    CHECK(first.branch_misses < 0);
+    CHECK(first.l1_misses < 0);
+    Perf_counts one = first.per(100);
+    CHECK(one.instructions == doctest::Approx(5));
+    CHECK(one.llc_misses < 0);
+    CHECK(not Perf_counts().any());
+
+    //counters may be unavailable in containers, then nothing is counted
+    Perf_counters counters;
+    counters.start();
+    counters.stop();
+    if (not counters.available())
+        CHECK(not counters.read().any());
+}
+
+TEST_CASE_TEMPLATE("Allocation free game check", Game, Snake, Packed_snake, Bit_snake, Fixed_snake<10>) {
+    Game game(10, 5);
+    game.reserve_body();
+    std::default_random_engine engine(3);
+    std::size_t longest = 0;
+    int games = 0;
+    long long count = allocations([&] {
+        for (int k = 0; k < 20000; k++) {
+            bot_turn(game, engine);
+            if (not game.move()) {
+                game.new_game();
+                games++;
+            }
+            longest = std::max(longest, game.body.size());
+        }
+    });
+    CHECK(count == 0);
+    CHECK(games > 0);
+    CHECK(longest > 8);
+
+    count = allocations([&] {
+        for (int k = 0; k < 1000; k++) {
+            game.field.create_apple();
+            game.field.body[game.field.apple.x][game.field.apple.y] = Empty_id;
+        }
+    });
+    CHECK(count == 0);
+}
+
+TEST_CASE("Allocation free render check") {
+    const unsigned rects[4][4] = {{0, 0, 2, 2}, {2, 0, 2, 2}, {4, 0, 2, 2}, {6, 0, 2, 2}};
+    std::vector<unsigned char> atlas(8 * 2 * 4);
+    Tile_set tiles(atlas.data(), 8, rects, 3);
+    Snake snake(16, 2);
+    snake.reserve_body();
+    Rasterizer rasterizer(tiles, 2);
+    int side = rasterizer.frame_size(snake.field);
+    std::vector<unsigned char> frame(std::size_t(side) * side * 3);
+    Terminal_renderer terminal;
+    rasterizer.render(snake.field, frame.data());
+    terminal.render(snake.field);
+    std::default_random_engine engine(4);
+    std::size_t bytes = 0;
+    long long count = allocations([&] {
+        for (int k = 0; k < 500; k++) {
+            bot_turn(snake, engine);
+            if (not snake.move())
+                snake.new_game();
+            rasterizer.render(snake.field, frame.data());
+            bytes += terminal.render(snake.field).size();
+        }
+    });
+    CHECK(count == 0);
+    CHECK(bytes > 0);
+}
+
+TEST_CASE_TEMPLATE("State checksum check", Game, Snake, Packed_snake, Bit_snake, Fixed_snake<16>) {
+    Game game(16, 8);
+    Snake reference(16, 8);
+    std::default_random_engine bot_engine(8), reference_bot(8);
+    State_checksum checksum(game), reference_checksum(reference);
+    bool same = true, incremental = true;
+    for (int tick = 0; tick < 5000; tick++) {
+        play_bot_tick(game, bot_engine, checksum);
+        play_bot_tick(reference, reference_bot, reference_checksum);
+        same = same and checksum.value(game) == reference_checksum.value(reference);
+        incremental = incremental and checksum.value(game) == State_checksum(game).value(game);
+    }
+    CHECK(same);
+    CHECK(incremental);
+    std::uint64_t before = checksum.value(game);
+    game.delta = Vector(-game.delta.x, -game.delta.y);
+    CHECK(checksum.value(game) != before);
+}
+
+TEST_CASE("Checksum stream check") {
+    std::FILE *file = std::tmpfile();
+    REQUIRE(file != nullptr);
+    CHECK(write_checksum_header(file, 10, 7));
+    for (int tick = 0; tick < 5; tick++)
+        CHECK(write_checksum(file, tick, mix64(tick)));
+    std::rewind(file);
+    Checksum_stream first;
+    REQUIRE(read_checksums(file, first));
+    std::fclose(file);
+    CHECK(first.size == 10);
+    CHECK(first.seed == 7);
+    REQUIRE(first.values.size() == 5);
+    CHECK(first.values[4] == mix64(4));
+    Checksum_stream second = first;
+    CHECK(first_divergence(first, second) == -1);
+    second.values.pop_back();
+    CHECK(first_divergence(first, second) == 4);
+    second.values[2] ^= 1;
+    CHECK(first_divergence(first, second) == 2);
+}
+
+TEST_CASE_TEMPLATE("Safe action mask check", Game, Snake, Packed_snake, Bit_snake, Fixed_snake<10>) {
+    Game game(10, 4);
+    std::default_random_engine engine(4);
+    bool matches = true;
+    for (int tick = 0; tick < 3000; tick++) {
+        unsigned mask = safe_actions(game);
+        for (int code = 0; code < 4; code++) {
+            Vector direction = direction_vector(code);
+            bool expected = game.last_delta + direction != Vector(0, 0) and is_safe(game, direction);
+            matches = matches and bool(mask >> code & 1) == expected;
+            if (game.last_delta + direction == Vector(0, 0))
+                continue;
+            Game copy = game;
+            apply_action(copy, code);
+            Step_result result = copy.step();
+            matches = matches and bool(mask >> code & 1) == (result.working() or result.event == Won_event);
+        }
+        bot_turn(game, engine);
+        if (not game.move())
+            game.new_game();
+    }
+    CHECK(matches);
+}
+
+TEST_CASE("Batch step and mask check") {
+    Batch<Snake> batch(40, 8, 100);
+    std::vector<Snake> games;
+    for (int k = 0; k < 40; k++)
+        games.emplace_back(8, 100 + k);
+    std::default_random_engine engine(6);
+    std::uniform_int_distribution<int> action(0, 5);
+    std::vector<unsigned char> actions(40);
+    std::vector<Step_result> results(40);
+    bool same = true;
+    for (int tick = 0; tick < 500; tick++) {
+        for (unsigned char &a : actions)
+            a = (unsigned char) action(engine);
+        batch.step(actions.data(), results.data());
+        for (int k = 0; k < 40; k++) {
+            apply_action(games[k], actions[k]);
+            Step_result expected = games[k].step();
+            same = same and results[k].event == expected.event and results[k].length == expected.length;
+            same = same and batch.games[k].body == games[k].body;
+            same = same and batch.safe_actions()[k] == safe_actions(games[k]);
+            if (not expected.working()) {
+                games[k].new_game();
+                batch.games[k].new_game();
+            }
+        }
+        batch.update_masks();
+        for (int k = 0; k < 40; k++)
+            same = same and batch.safe_actions()[k] == safe_actions(games[k]);
+    }
+    CHECK(same);
+    CHECK(batch.size() == 40);
+}
+
+TEST_CASE("Batch auto reset and async step check") {
+    Batch<Snake> batch(30, 6, 200, true);
+    Batch<Snake> async(30, 6, 200, true, 3);
+    std::vector<Snake> games;
+    for (int k = 0; k < 30; k++) {
+        games.emplace_back(6, 200 + k);
+        games.back().reserve_body();
+    }
+    std::default_random_engine engine(8);
+    std::uniform_int_distribution<int> action(0, 5);
+    std::vector<unsigned char> actions(30);
+    std::vector<Step_result> results(30);
+    bool same = true;
+    int ended = 0;
+    long long count = allocations([&] {
+        for (int tick = 0; tick < 400; tick++) {
+            for (unsigned char &a : actions)
+                a = (unsigned char) action(engine);
+            async.step_async(actions.data());
+            batch.step(actions.data(), results.data());
+            const Step_result *async_results = async.wait();
+            for (int k = 0; k < 30; k++) {
+                apply_action(games[k], actions[k]);
+                Step_result expected = games[k].step();
+                same = same and results[k].event == expected.event and async_results[k].event == expected.event;
+                if (not expected.working()) {
+                    ended++;
+                    same = same and batch.terminal_game(k).body == games[k].body;
+                    same = same and async.terminal_game(k).body == games[k].body;
+                    games[k].new_game();
+                }
+                same = same and batch.games[k].body == games[k].body and async.games[k].body == games[k].body;
+                same = same and batch.safe_actions()[k] == safe_actions(games[k]);
+                same = same and async.safe_actions()[k] == safe_actions(games[k]);
+            }
+        }
+    });
+    CHECK(count == 0);
+    CHECK(same);
+    CHECK(ended > 0);
+}
+
+TEST_CASE("Arena head-on and tail check") {
+    //heads at (3, 5) and (7, 5) facing up, no apples
+    Arena arena(11, 2, 1, 0);
+    CHECK(arena.snakes[0].head == Vector(3, 5));
+    CHECK(arena.snakes[1].head == Vector(7, 5));
+    arena.snakes[0].right();
+    arena.snakes[1].left();
+    CHECK(arena.step()[0].event == Moved_event);
+    const Step_result *results = arena.step();
+    CHECK(results[0].event == Head_event);
+    CHECK(results[1].event == Head_event);
+    CHECK(arena.alive() == 0);
+    CHECK(arena.field.body[5][5] == Empty_id);
+    CHECK(arena.step()[0].event == Out_event);
+
+    //the longer head takes the contested cell and the apple
+    arena.new_game();
+    CHECK(arena.place_apple(Vector(4, 5)));
+    arena.snakes[0].right();
+    arena.snakes[1].left();
+    CHECK(arena.step()[0].event == Ate_event);
+    CHECK(arena.place_apple(Vector(5, 5)));
+    results = arena.step();
+    CHECK(results[0].event == Ate_event);
+    CHECK(results[0].length == 4);
+    CHECK(results[1].event == Head_event);
+    CHECK(arena.owner(Vector(5, 5)) == 0);
+
+    //equal heads on an apple both lose and the apple stays
+    arena.new_game();
+    arena.snakes[0].right();
+    arena.snakes[1].left();
+    arena.step();
+    CHECK(arena.place_apple(Vector(5, 5)));
+    results = arena.step();
+    CHECK(results[0].event == Head_event);
+    CHECK(results[1].event == Head_event);
+    CHECK(arena.field.body[5][5] == Apple_id);
+
+    //a leaving tail may be followed, a tail of a snake that eats may not
+    for (bool feed : {false, true}) {
+        arena.new_game();
+        arena.snakes[0].right();
+        arena.snakes[1].left();
+        arena.step();
+        arena.snakes[1].up();
+        arena.step();
+        if (feed)
+            CHECK(arena.place_apple(Vector(6, 3)));
+        results = arena.step();
+        CHECK(results[0].event == (feed ? Collision_event : Moved_event));
+        CHECK(results[1].event == (feed ? Ate_event : Moved_event));
+        CHECK(arena.owner(Vector(6, 5)) == (feed ? 1 : 0));
+    }
+}
+
+TEST_CASE("Arena argument check") {
+    CHECK_THROWS_AS(Arena(11, 0, 1), std::invalid_argument);
+    CHECK_THROWS_AS(Arena(64, 256, 1), std::invalid_argument);
+    CHECK_THROWS_AS(Arena(8, 16, 1), std::invalid_argument);
+    CHECK_NOTHROW(Arena(15, 16, 1));
+}
+
+TEST_CASE("Arena random game check") {
+    auto play = [](std::vector<int> &events) {
+        Arena arena(24, 9, 5, 3);
+        events.reserve(2200 * arena.snakes.size());
+        std::default_random_engine engine(9);
+        std::uniform_int_distribution<int> action(0, 7);
+        bool consistent = true;
+        auto tick = [&] {
+            for (Arena_snake &snake : arena.snakes)
+                apply_action(snake, action(engine));
+            const Step_result *results = arena.step();
+            for (std::size_t k = 0; k < arena.snakes.size(); k++)
+                events.push_back(results[k].event);
+            if (arena.alive() < 2)
+                arena.new_game();
+        };
+        for (int k = 0; k < 200; k++)
+            tick();
+        consistent = consistent and allocations([&] {
+            for (int k = 0; k < 2000; k++)
+                tick();
+        }) == 0;
+        int parts = 0, cells = 0, apples = 0;
+        for (const Arena_snake &snake : arena.snakes) {
+            if (not snake.alive)
+                continue;
+            parts += snake.length;
+            consistent = consistent and arena.owner(snake.head) == &snake - arena.snakes.data();
+        }
+        for (int x = 0; x < 24; x++)
+            for (int y = 0; y < 24; y++) {
+                cells += arena.field.body[x][y] == Snake_id;
+                apples += arena.field.body[x][y] == Apple_id;
+            }
+        return consistent and parts == cells and apples == 3;
+    };
+    std::vector<int> first, second;
+    CHECK(play(first));
+    CHECK(play(second));
+    CHECK(first == second);
+    CHECK(std::count(first.begin(), first.end(), Head_event) + std::count(first.begin(), first.end(), Collision_event) > 0);
+}